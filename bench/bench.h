@@ -0,0 +1,130 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <time.h>
+
+#include "ecrt_stub.h"
+
+/** Runs of each measurement, median is reported. */
+#define BENCH_RUNS 15
+
+/*****************************************************************************/
+
+inline static int64_t bench_ns()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+inline static int64_t bench_median(std::vector<int64_t> samples)
+{
+	std::sort(samples.begin(), samples.end());
+
+	return samples[samples.size() / 2];
+}
+
+// Synthetic bus of IO terminals, half of entries of a slave are outputs on
+// SM2 and half are inputs on SM3, one 16-bit entry per PDO. Two products
+// alternate, so there are two distinct PDO layouts.
+inline static void bench_bus(uint16_t slaves, uint16_t entries_per_slave,
+	std::vector<stubSlave> &bus)
+{
+	bus.clear();
+
+	for(uint16_t position = 0; position < slaves; position++){
+		stubSlave slave = { 0, 0x00000002, 0x1000u + position % 2, 0, {} };
+
+		slave.syncs.push_back({ 0, EC_DIR_OUTPUT, EC_WD_DEFAULT, {} });
+		slave.syncs.push_back({ 1, EC_DIR_INPUT, EC_WD_DEFAULT, {} });
+		slave.syncs.push_back({ 2, EC_DIR_OUTPUT, EC_WD_ENABLE, {} });
+		slave.syncs.push_back({ 3, EC_DIR_INPUT, EC_WD_DEFAULT, {} });
+
+		for(uint16_t i_entry = 0; i_entry < entries_per_slave; i_entry++){
+			bool is_output = i_entry % 2 == 0;
+			uint16_t channel = i_entry / 2;
+
+			stubPdo pdo = {
+					(uint16_t) ((is_output ? 0x1600 : 0x1a00) + channel),
+					{}
+				};
+			pdo.entries.push_back({
+					(uint16_t) ((is_output ? 0x7000 : 0x6000) + (channel << 4)),
+					0x01,
+					16
+				});
+
+			slave.syncs[is_output ? 2 : 3].pdos.push_back(pdo);
+		}
+
+		bus.push_back(slave);
+	}
+}
+
+// Slave configuration JSON of the whole bus, every entry added to domain
+inline static std::string bench_config_json(const std::vector<stubSlave> &bus)
+{
+	std::string json = "[";
+	char text[128];
+
+	for(size_t position = 0; position < bus.size(); position++){
+		const stubSlave &slave = bus[position];
+
+		snprintf(text, sizeof(text), "%s{\"alias\":%u,\"position\":%zu,"
+			"\"vendor_id\":\"0x%08x\",\"product_code\":\"0x%08x\",\"syncs\":[",
+			position ? "," : "", slave.alias, position, slave.vendor_id,
+			slave.product_code);
+		json += text;
+
+		bool is_first_sync = true;
+
+		for(const stubSync &sync : slave.syncs){
+			if(sync.pdos.empty()){
+				continue;
+			}
+
+			snprintf(text, sizeof(text), "%s{\"index\":%u,\"direction\":\"%s\","
+				"\"watchdog_enabled\":%s,\"pdos\":[",
+				is_first_sync ? "" : ",", sync.index,
+				sync.dir == EC_DIR_INPUT ? "input" : "output",
+				sync.watchdog_mode == EC_WD_ENABLE ? "true" : "false");
+			json += text;
+			is_first_sync = false;
+
+			for(size_t i_pdo = 0; i_pdo < sync.pdos.size(); i_pdo++){
+				const stubPdo &pdo = sync.pdos[i_pdo];
+
+				snprintf(text, sizeof(text), "%s{\"index\":\"0x%04x\",\"entries\":[",
+					i_pdo ? "," : "", pdo.index);
+				json += text;
+
+				for(size_t i_entry = 0; i_entry < pdo.entries.size(); i_entry++){
+					const ec_pdo_entry_info_t &entry = pdo.entries[i_entry];
+
+					snprintf(text, sizeof(text), "%s{\"index\":\"0x%04x\","
+						"\"subindex\":\"0x%02x\",\"size\":%u,\"add_to_domain\":true}",
+						i_entry ? "," : "", entry.index, entry.subindex,
+						entry.bit_length);
+					json += text;
+				}
+
+				json += "]}";
+			}
+
+			json += "]}";
+		}
+
+		json += "]}";
+	}
+
+	json += "]";
+
+	return json;
+}
+
+#endif
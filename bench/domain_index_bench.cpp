@@ -0,0 +1,105 @@
+// Cost of get_domain_index() hits and misses with number of domain entries.
+// Keys are looked up in shuffled order, so lookups don't share cache lines.
+#include <random>
+
+#include "../src/ecat.cc"
+#include "bench.h"
+
+/** Lookups of each measurement. */
+#define BENCH_LOOKUPS 1000000
+
+/*****************************************************************************/
+
+struct benchKey {
+	ecat_pos_al position;
+	ecat_index_al index;
+	ecat_sub_al subindex;
+};
+
+static int64_t bench_lookups(const std::vector<benchKey> &keys, io_size_et *found)
+{
+	std::vector<int64_t> samples;
+
+	for(uint8_t run = 0; run < BENCH_RUNS; run++){
+		io_size_et sum = 0;
+		int64_t started_ns = bench_ns();
+
+		for(uint32_t i_lookup = 0; i_lookup < BENCH_LOOKUPS; i_lookup++){
+			const benchKey &key = keys[i_lookup % keys.size()];
+			io_size_et dmn_idx = 0;
+
+			if(get_domain_index(&dmn_idx, key.position, key.index, key.subindex) == 0){
+				sum += dmn_idx;
+			} else {
+				sum--;
+			}
+		}
+
+		samples.push_back(bench_ns() - started_ns);
+		*found = sum;
+	}
+
+	return bench_median(samples);
+}
+
+static void bench_domain_index(uint16_t entries, uint16_t entries_per_slave)
+{
+	bench_bus(entries / entries_per_slave, entries_per_slave, stub_bus);
+
+	std::string json = bench_config_json(stub_bus);
+
+	jsConfig config;
+	config.json = json.c_str();
+	config.length = json.size();
+
+	if(configure_slaves(config) != 0){
+		fprintf(stderr, "Failed configuring %u entries\n", entries);
+		exit(EXIT_FAILURE);
+	}
+
+	init_master_and_domain();
+
+	std::mt19937 random(entries);
+	std::vector<benchKey> hits;
+	std::vector<benchKey> misses;
+
+	for(const slaveEntry &io : IOs){
+		hits.push_back({ io.position, io.index, io.subindex });
+
+		// same slave and object, subindex which isn't mapped
+		misses.push_back({ io.position, io.index, 0x7f });
+	}
+
+	std::shuffle(hits.begin(), hits.end(), random);
+	std::shuffle(misses.begin(), misses.end(), random);
+
+	io_size_et found;
+	int64_t hit_ns = bench_lookups(hits, &found);
+	int64_t miss_ns = bench_lookups(misses, &found);
+
+	if(found != -BENCH_LOOKUPS){
+		fprintf(stderr, "Unexpected hit of unmapped entry\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("%7u %6u %9.1f %9.1f\n", entries, entries / entries_per_slave,
+		(double) hit_ns / BENCH_LOOKUPS, (double) miss_ns / BENCH_LOOKUPS);
+
+	ecrt_release_master(master);
+	reset_global_vars();
+}
+
+int main()
+{
+	printf("get_domain_index() in ns per lookup, median of %d runs of %d lookups\n",
+		BENCH_RUNS, BENCH_LOOKUPS);
+	printf("%7s %6s %9s %9s\n", "entries", "slaves", "hit", "miss");
+
+	const uint16_t entries[] = { 100, 1000, 5000, 10000, 20000, 60000 };
+
+	for(uint16_t count : entries){
+		bench_domain_index(count, 8);
+	}
+
+	return 0;
+}
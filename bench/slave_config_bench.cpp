@@ -0,0 +1,70 @@
+// Scaling of slave_startup_config() and of whole startup with number of
+// entries. Time per entry stays flat as long as they're linear.
+#include "../src/ecat.cc"
+#include "bench.h"
+
+/*****************************************************************************/
+
+static void bench_slave_config(uint16_t entries, uint16_t entries_per_slave)
+{
+	uint16_t slaves = entries / entries_per_slave;
+
+	bench_bus(slaves, entries_per_slave, stub_bus);
+
+	std::string json = bench_config_json(stub_bus);
+
+	jsConfig config;
+	config.json = json.c_str();
+	config.length = json.size();
+
+	if(configure_slaves(config) != 0){
+		fprintf(stderr, "Failed configuring %u entries\n", entries);
+		exit(EXIT_FAILURE);
+	}
+
+	std::vector<int64_t> slave_configs;
+	std::vector<int64_t> startups;
+
+	for(uint8_t run = 0; run < BENCH_RUNS; run++){
+		init_slave();
+		master = ecrt_request_master(0);
+
+		int64_t started_ns = bench_ns();
+		slave_startup_config(master);
+		slave_configs.push_back(bench_ns() - started_ns);
+
+		ecrt_release_master(master);
+		reset_global_vars();
+
+		started_ns = bench_ns();
+		init_master_and_domain();
+		startups.push_back(bench_ns() - started_ns);
+
+		ecrt_release_master(master);
+		reset_global_vars();
+	}
+
+	int64_t slave_config_ns = bench_median(slave_configs);
+	int64_t startup_ns = bench_median(startups);
+
+	printf("%7u %6u %11.1f %9.1f %11.1f %9.1f\n", entries, slaves,
+		slave_config_ns / 1e3, (double) slave_config_ns / entries,
+		startup_ns / 1e3, (double) startup_ns / entries);
+}
+
+int main()
+{
+	printf("slave_startup_config() and whole startup, median of %d runs\n",
+		BENCH_RUNS);
+	printf("%7s %6s %11s %9s %11s %9s\n", "entries", "slaves", "slave_cfg", "per_entry",
+		"startup", "per_entry");
+	printf("%7s %6s %11s %9s %11s %9s\n", "", "", "us", "ns", "us", "ns");
+
+	const uint16_t entries[] = { 1000, 2000, 5000, 10000, 20000 };
+
+	for(uint16_t count : entries){
+		bench_slave_config(count, 8);
+	}
+
+	return 0;
+}
@@ -0,0 +1,72 @@
+// Startup time of large configurations against stub library, from requesting
+// master until it's activated. Addon is compiled in, so startup runs exactly
+// like init() does.
+#include "../src/ecat.cc"
+#include "bench.h"
+
+/*****************************************************************************/
+
+static void bench_startup(uint16_t slaves, uint16_t entries_per_slave)
+{
+	bench_bus(slaves, entries_per_slave, stub_bus);
+
+	std::string json = bench_config_json(stub_bus);
+
+	jsConfig config;
+	config.json = json.c_str();
+	config.length = json.size();
+
+	if(configure_slaves(config) != 0){
+		fprintf(stderr, "Failed configuring %u slaves\n", slaves);
+		exit(EXIT_FAILURE);
+	}
+
+	std::vector<int64_t> phases[PHASE_COUNT];
+	std::vector<int64_t> totals;
+	stubCalls calls = {};
+
+	for(uint8_t run = 0; run < BENCH_RUNS; run++){
+		stub_calls = {};
+		reset_startup_phases();
+
+		int64_t started_ns = bench_ns();
+
+		init_master_and_domain();
+		activate_master();
+
+		totals.push_back(bench_ns() - started_ns);
+		calls = stub_calls;
+
+		for(uint8_t phase = PHASE_SLAVE_CONFIG; phase <= PHASE_MASTER_ACTIVATION; phase++){
+			phases[phase].push_back(startup_phases[phase].load());
+		}
+
+		ecrt_release_master(master);
+		reset_global_vars();
+	}
+
+	printf("%6u %7u", slaves, slaves * entries_per_slave);
+	for(uint8_t phase = PHASE_SLAVE_CONFIG; phase <= PHASE_MASTER_ACTIVATION; phase++){
+		printf(" %9.1f", bench_median(phases[phase]) / 1e3);
+	}
+	printf(" %9.1f %8u %8u\n", bench_median(totals) / 1e3, calls.pdo_config,
+		calls.total);
+}
+
+int main()
+{
+	printf("Startup time in us, median of %d runs, and library calls of one startup\n",
+		BENCH_RUNS);
+	printf("%6s %7s", "slaves", "entries");
+	for(uint8_t phase = PHASE_SLAVE_CONFIG; phase <= PHASE_MASTER_ACTIVATION; phase++){
+		printf(" %9.9s", startup_phase_names[phase]);
+	}
+	printf(" %9s %8s %8s\n", "total", "pdo_cfg", "calls");
+
+	bench_startup(100, 8);
+	bench_startup(250, 8);
+	bench_startup(500, 8);
+	bench_startup(500, 32);
+
+	return 0;
+}
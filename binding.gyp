@@ -9,7 +9,12 @@
 		],
 		"sources": [
 			"./src/ecat.cc",
-			"./src/include/config_parser.cpp"
+			"./src/include/config_parser.cpp",
+			"./src/include/bus_scanner.cpp",
+			"./src/include/esi_parser.cpp",
+			"./src/include/config_diff.cpp",
+			"./src/include/pdo_config.cpp",
+			"./src/include/capacity_planner.cpp"
 		],
 		"link_settings": {
 			"libraries": [
@@ -1,42 +1,28 @@
 const fs = require('fs');
+const path = require('path');
 
 const EventEmitter = require('events');
 const ecat = require('bindings')('ecat');
-const {hrtime} = process;
-
-const MovingAvg = require('./class/movingAverage.class.js');
 
 const _config = {
 	slaveJSON: undefined,
 	data: undefined,
+	scaled: undefined,
 	state: undefined,
-	interval: 0n,
+	interval: 0,
 	frequency: 1000,
 	domain: undefined,
 	doSortSlave: false,
+	cachePath: undefined,
+	esiFiles: [],
 };
 
+// slave configuration is validated against this schema in native parser
+const SCHEMA_PATH = path.join(__dirname, '..', 'slave-configuration.schema.json');
+
 const _cycle = {
 	frequency: 1000,
 	period: 0,
-	latency: {
-		current: 0n,
-		last: 0n,
-		diff: 0n,
-	},
-	timer: 0n,
-};
-
-const _average = {
-	lastN: 10,
-	jitter: new MovingAvg(this.lastN),
-	latency: new MovingAvg(this.lastN),
-	get values(){
-		return {
-			latency: this.latency.val,
-			jitter: this.jitter.val,
-		}
-	},
 };
 
 class ECAT extends EventEmitter{
@@ -45,7 +31,7 @@ class ECAT extends EventEmitter{
 		const self = this;
 
 		self._dmnAddr2Idx = {};
-		self._timer = 0n;
+		self._timer = 0;
 		self.isReady = false;
 
 		if(slaveJSON && freq){
@@ -95,7 +81,10 @@ class ECAT extends EventEmitter{
 
 	/**
 	 *	set slave configuration json file path
-	 *	@param {string|Object[]} configuration - json file path or array of objects
+	 *	@param {string|Buffer|Object[]|Object} configuration - json file path,
+	 *	Buffer with json, array of slaves or object with 'slaves' and shared
+	 *	'profiles'. Buffer and objects are passed to native side as they are,
+	 *	without converting them to string
 	 * 	@example etherlab.setSlaveConfigPath('./slaves.json');
 	 * */
 	setSlaveConfig(configuration){
@@ -105,17 +94,18 @@ class ECAT extends EventEmitter{
 				return;
 			}
 
-			const JSONString = fs.readFileSync(configuration);
-			_config.slaveJSON = JSONString.toString();
+			_config.slaveJSON = fs.readFileSync(configuration);
 			return;
 		}
 
-		if(Array.isArray(configuration)){
-			_config.slaveJSON = JSON.stringify(configuration);
+		if(Buffer.isBuffer(configuration)
+			|| Array.isArray(configuration)
+			|| (configuration !== null && typeof(configuration) === 'object')){
+			_config.slaveJSON = configuration;
 			return;
 		}
 
-		throw `Config must be a file path to JSON file or an array of objects '`;
+		throw `Config must be a file path to JSON file, a Buffer, an array or an object '`;
 		return;
 	}
 
@@ -139,10 +129,14 @@ class ECAT extends EventEmitter{
 
 	/**
 	 *	Set frequency and slave config
-	 *	@param {string|Object[]} configuration - json file path or array of objects
+	 *	@param {string|Buffer|Object[]|Object} configuration - json file path,
+	 *	Buffer with json, array of slaves or object with 'slaves' and shared
+	 *	'profiles'
 	 *	@param {number} freq - frequency in Hertz
 	 *	@param {boolen} doSortSlave - to sort the slaves, 'true' must be passed
 	 *	@returns {Object} cyclick task frequency and period wrapped as object
+	 *	@throws error with line and column, or with path of the value for
+	 *	objects, if slave configuration is invalid
 	 * 	@example etherlab.init('./slaves.json', 1000);
 	 * */
 	init(configuration, freq, doSortSlave = false){
@@ -155,31 +149,186 @@ class ECAT extends EventEmitter{
 			_config.doSortSlave = true;
 		}
 
-		ecat.init(_config.slaveJSON, _config.doSortSlave);
+		// compiled configuration is keyed by hash of JSON text, objects are
+		// only stringified when it's used
+		const configJSON = _config.cachePath !== undefined
+			? self._toJSON(_config.slaveJSON)
+			: _config.slaveJSON;
+
+		// throws error with line and column if configuration is invalid
+		ecat.init(configJSON, _config.doSortSlave, self._readSchema(),
+			_config.cachePath, _config.esiFiles);
 	}
 
 	/**
-	 *	calculate last n data moving average of latency and jitter
+	 *	convert slave configuration object to JSON string
 	 *	@private
+	 *	@param {string|Buffer|Object[]|Object} configuration - slave configuration
+	 *	@returns {string|Buffer} JSON string, or configuration if it's already JSON
 	 * */
-	_calcLatency(){
+	_toJSON(configuration){
+		return typeof(configuration) === 'string' || Buffer.isBuffer(configuration)
+			? configuration
+			: JSON.stringify(configuration);
+	}
+
+	/**
+	 *	read slave configuration schema
+	 *	@private
+	 *	@returns {string|undefined} schema as JSON string, undefined if not found
+	 * */
+	_readSchema(){
+		return fs.existsSync(SCHEMA_PATH)
+			? fs.readFileSync(SCHEMA_PATH).toString()
+			: undefined;
+	}
+
+	/**
+	 *	Set path of compiled slave configuration used by init().
+	 *	If the source configuration and the schema validating it are unchanged,
+	 *	the compiled one is loaded instead of parsing the JSON, otherwise it is
+	 *	recompiled.
+	 *	Must be called before init()
+	 *	@param {string|undefined} cachePath - compiled configuration file path,
+	 *	undefined to disable
+	 * 	@example etherlab.setConfigCache('/var/cache/slaves.ecatcfg');
+	 * */
+	setConfigCache(cachePath){
+		_config.cachePath = cachePath;
+	}
+
+	/**
+	 *	Set vendor's ESI XML files used by init() and compile(). Default PDOs
+	 *	of slaves defined without 'syncs' are taken from these files, matched
+	 *	by vendor_id, product_code and optional revision. Such slaves, couplers
+	 *	included, must be found in these files, otherwise init() and compile()
+	 *	throw. Slaves whose ESI file isn't loaded can define empty 'syncs'.
+	 *	Must be called before init()
+	 *	@param {string[]} esiFiles - ESI XML file paths, empty to disable
+	 *	@throws error if any of the files is not found
+	 * 	@example etherlab.setEsiFiles(['/opt/esi/Beckhoff EL2xxx.xml']);
+	 * */
+	setEsiFiles(esiFiles = []){
+		for(const esiFile of esiFiles){
+			if(!fs.existsSync(esiFile)){
+				throw `File Not Found! '${esiFile}'`;
+			}
+		}
+
+		_config.esiFiles = esiFiles;
+	}
+
+	/**
+	 *	Compile slave configuration into binary file without initializing master
+	 *	@param {string|Buffer|Object[]|Object} configuration - json file path,
+	 *	Buffer with json, array of slaves or object with 'slaves' and shared
+	 *	'profiles'
+	 *	@param {string} cachePath - compiled configuration file path
+	 *	@param {boolen} doSortSlave - to sort the slaves, 'true' must be passed.
+	 *	Must be the same value as passed to init()
+	 *	@returns {number} number of slave entries
+	 *	@throws error with line and column if slave configuration is invalid
+	 * 	@example etherlab.compile('./slaves.json', '/var/cache/slaves.ecatcfg');
+	 * */
+	compile(configuration, cachePath, doSortSlave = false){
 		const self = this;
 
-		_cycle.latency.current = hrtime.bigint() - _cycle.timer;
-		_cycle.timer = hrtime.bigint();
+		self.setSlaveConfig(configuration);
 
-		if(_cycle.latency.last == 0n){
-			_cycle.latency.last = _cycle.latency.current;
-			return;
+		return ecat.compile(self._toJSON(_config.slaveJSON), cachePath, doSortSlave === true,
+			self._readSchema(), _config.esiFiles);
+	}
+
+	/**
+	 *	Apply changed slave configuration without releasing the master.
+	 *	Changed startup parameters are written to the slaves by SDO, other
+	 *	changes (identity, SMs, PDOs, entries, added or removed slaves) are
+	 *	only reported and require stop() and init() with the new configuration
+	 *	@param {string|Buffer|Object[]|Object} configuration - json file path,
+	 *	Buffer with json, array of slaves or object with 'slaves' and shared
+	 *	'profiles'
+	 *	@returns {Promise<Object>} { restartRequired, changes: [{ position, change }] },
+	 *	resolved once changed parameters are written. Written parameters are
+	 *	used by the next start() only if all writes succeeded
+	 *	@throws error with line and column if slave configuration is invalid,
+	 *	or if master is being re-initialized or previous reconfigure() is
+	 *	still writing parameters
+	 * 	@example const { restartRequired } = await etherlab.reconfigure('./slaves.json');
+	 * */
+	async reconfigure(configuration){
+		const self = this;
+		const previous = _config.slaveJSON;
+
+		self.setSlaveConfig(configuration);
+
+		let result;
+		try{
+			result = ecat.reconfigure(_config.slaveJSON, self._readSchema());
+		} catch(error) {
+			_config.slaveJSON = previous;
+			throw error;
 		}
 
-		_cycle.latency.diff = Math.abs(
-				Number(_cycle.latency.last - _cycle.latency.current)
-			);
-		_cycle.latency.last = _cycle.latency.current;
+		// running configuration is kept if it can't be applied in place
+		if(result.restartRequired){
+			_config.slaveJSON = previous;
+		}
+
+		await Promise.all(result.writes);
+
+		return {
+			restartRequired: result.restartRequired,
+			changes: result.changes,
+		};
+	}
+
+	/**
+	 *	Estimate cyclic bus load of slave configuration without initializing
+	 *	master. Process data of SMs with domain entries is packed into LRW
+	 *	datagrams and Ethernet frames like master does, bus time is the wire
+	 *	time of these frames plus processing delay of every slave
+	 *	@param {string|Buffer|Object[]|Object} configuration - json file path,
+	 *	Buffer with json, array of slaves or object with 'slaves' and shared
+	 *	'profiles'
+	 *	@param {Object} options - { periodNs, linkSpeed, slaveDelayNs }, period
+	 *	defaults to period of setFrequency(), link speed to 100 Mbit/s and slave
+	 *	delay to 1000 ns
+	 *	@returns {Object} { domainSize, inputBytes, outputBytes, datagrams,
+	 *	frames, wireBytes, wireTimeNs, busTimeNs, minPeriodNs, periodNs, load,
+	 *	fits, slaves: [{ position, inputBytes, outputBytes, wireTimeNs }] }
+	 *	@throws error with line and column if slave configuration is invalid
+	 * 	@example const { minPeriodNs } = etherlab.planCapacity('./slaves.json');
+	 * */
+	planCapacity(configuration, options = {}){
+		const self = this;
+		const previous = _config.slaveJSON;
+
+		// planned configuration doesn't replace the one used by init()
+		self.setSlaveConfig(configuration);
+		const planned = _config.slaveJSON;
+		_config.slaveJSON = previous;
 
-		_average.jitter.add(Number(_cycle.latency.diff));
-		_average.latency.add(Number(_cycle.latency.current));
+		return ecat.planCapacity(planned, options.periodNs, options.linkSpeed,
+			options.slaveDelayNs, self._readSchema(), _config.esiFiles);
+	}
+
+	/**
+	 *	Scan slaves attached to the bus and generate slave configuration from
+	 *	their SMs, PDOs and PDO entries
+	 *	@param {boolen} doLoad - to initialize master with the scanned
+	 *	configuration instead of calling init(), 'true' must be passed
+	 *	@returns {Object[]} generated slave configuration
+	 *	@throws error if master can't be requested or bus can't be read
+	 * 	@example fs.writeFileSync('./slaves.json', JSON.stringify(etherlab.scan()));
+	 * */
+	scan(doLoad = false){
+		const JSONString = ecat.scan(doLoad === true);
+
+		if(doLoad === true){
+			_config.slaveJSON = JSONString;
+		}
+
+		return JSON.parse(JSONString);
 	}
 
 	/**
@@ -207,17 +356,20 @@ class ECAT extends EventEmitter{
 		}
 
 		try{
-			_cycle.timer = hrtime.bigint();
-			self._timer = _cycle.timer;
+			self._timer = 0;
 
 			ecat.start(async (...args) => {
 				try{
 					const data = args[0];
 					const state = args[1];
+					const timestamp = args[2];
+					const latency = args[3];
+					const scaled = args[4];
 					const masterState = self.getMasterStateDetails();
 					const isOperational = masterState.OP;
 
 					_config.data = data;
+					_config.scaled = scaled;
 
 					if(_config.state != state){
 						self._emit('state', state);
@@ -235,17 +387,13 @@ class ECAT extends EventEmitter{
 					// if master is not in OP state, skip emitting data
 					if(!isOperational){
 						// reset timer
-						_cycle.timer = hrtime.bigint();
-						self._timer = _cycle.timer;
+						self._timer = timestamp;
 						return;
 					}
 
-					const current = hrtime.bigint();
-					self._calcLatency();
-
-					if(!_config.interval || current - self._timer >= _config.interval){
-						self._emit('data', data, _cycle.latency.current);
-						self._timer = hrtime.bigint();
+					if(!_config.interval || timestamp - self._timer >= _config.interval){
+						self._emit('data', data, latency, scaled);
+						self._timer = timestamp;
 					}
 				} catch(error) {
 					console.error('start Error', error);
@@ -262,7 +410,7 @@ class ECAT extends EventEmitter{
 	 *	@param {number} position - slave position
 	 *	@param {number} index - CoE index
 	 *	@param {number} subindex - CoE subindex
-	 *	@returns {number} domain value if domain exists, otherwise will return undefined
+	 *	@returns {number|bigint} domain value if domain exists, otherwise will return undefined
 	 * 	@example etherlab.read(1, 0x7000, 0x01);
 	 * */
 	read(position, index, subindex){
@@ -275,7 +423,8 @@ class ECAT extends EventEmitter{
 	 *	@param {number} position - slave position
 	 *	@param {number} index - CoE index
 	 *	@param {number} subindex - CoE subindex
-	 *	@param {number} value - value to be written
+	 *	@param {number|bigint} value - value to be written, in engineering unit
+	 *	if the entry has 'scale' or 'offset'
 	 *	@returns {number} failed write will return -1, otherwise returns the value
 	 * 	@example etherlab.writeIndex(1, 0x7000, 0x01, 0x1fff);
 	 * */
@@ -283,6 +432,85 @@ class ECAT extends EventEmitter{
 		return ecat.writeDomain(position, index, subindex, value);
 	}
 
+	/**
+	 *	Resolve domain index identified by slave position, index and subindex.
+	 *	Resolved index is stable as long as the master is not re-initialized,
+	 *	and can be passed to readIndex() and writeIndex() to skip key lookup
+	 *	@param {number} position - slave position
+	 *	@param {number} index - CoE index
+	 *	@param {number} subindex - CoE subindex
+	 *	@returns {number|undefined} domain index if domain exists, otherwise undefined
+	 * 	@example const handle = etherlab.resolve(1, 0x7000, 0x01);
+	 * */
+	resolve(position, index, subindex){
+		return ecat.resolve(position, index, subindex);
+	}
+
+	/**
+	 *	Read value from domain identified by its index
+	 *	@param {number} index - domain index, i.e. returned by resolve()
+	 *	@returns {number|bigint|undefined} domain value if index is valid, otherwise undefined
+	 * 	@example etherlab.readIndex(handle);
+	 * */
+	readIndex(index){
+		return ecat.readIndex(index);
+	}
+
+	/**
+	 *	Read values of multiple domains in a single call.
+	 *	All values are taken from the same cycle
+	 *	@param {Uint32Array} indexes - domain indexes, i.e. returned by resolve()
+	 *	@param {Float64Array} [values] - output array, reuse it to avoid allocation
+	 *	@returns {Float64Array|null} domain values, NaN for invalid index.
+	 *		Returns null if cyclic task is not running
+	 * 	@example etherlab.readIndexes(handles, values);
+	 * */
+	readIndexes(indexes, values = new Float64Array(indexes.length)){
+		return ecat.readIndexes(indexes, values);
+	}
+
+	/**
+	 *	Resolve domain index identified by entry name
+	 *	@param {string} name - entry name, as defined in slave configuration
+	 *	@returns {number|undefined} domain index if name exists, otherwise undefined
+	 * 	@example const handle = etherlab.resolveName('motor1.targetVelocity');
+	 * */
+	resolveName(name){
+		return ecat.resolveName(name);
+	}
+
+	/**
+	 *	Read value from domain identified by entry name
+	 *	@param {string} name - entry name, as defined in slave configuration
+	 *	@returns {number|bigint|undefined} domain value if name exists, otherwise undefined
+	 * 	@example etherlab.readName('motor1.actualVelocity');
+	 * */
+	readName(name){
+		return ecat.readName(name);
+	}
+
+	/**
+	 *	Write value into domain identified by entry name
+	 *	@param {string} name - entry name, as defined in slave configuration
+	 *	@param {number|bigint} value - value to be written, in engineering unit
+	 *	if the entry has 'scale' or 'offset'
+	 *	@returns {boolean|undefined} true if value is written, otherwise undefined
+	 * 	@example etherlab.writeName('motor1.targetVelocity', 1500);
+	 * */
+	writeName(name, value){
+		return ecat.writeName(name, value);
+	}
+
+	/**
+	 *	Get values of all named entries, taken from the same cycle
+	 *	@returns {Object|null} values keyed by entry name.
+	 *		Returns null if cyclic task is not running
+	 * 	@example const { 'motor1.actualVelocity': velocity } = etherlab.getNamedValues();
+	 * */
+	getNamedValues(){
+		return ecat.getNamedValues();
+	}
+
 	/**
 	 *	Get mapped domain's indexes stored inside C++ variable
 	 *	@param {boolean} doPrint - if true, will print mapped domain elements
@@ -298,7 +526,7 @@ class ECAT extends EventEmitter{
 	/**
 	 *	Write value into domain identified by its index
 	 *	@param {number} index - domain index
-	 *	@param {number} value - value to be written
+	 *	@param {number|bigint} value - value to be written
 	 *	@returns {number} failed write will return -1, otherwise returns the value
 	 * 	@example etherlab.writeIndex(1, 0x1fff);
 	 * 	@example etherlab.writeIndex({index: 1, value: 0x1fff});
@@ -342,22 +570,22 @@ class ECAT extends EventEmitter{
 	 * 	@private
 	 *	@param {number} val - number to be converted
 	 *	@param {('us'|'ms'|'s')} unit - time unit
-	 *	@returns {number} time in nanoseconds as BigInt
+	 *	@returns {number} time in nanoseconds
 	 * */
 	_toNanoseconds(val, unit){
-		val = BigInt(val);
+		val = Number(val);
 
 		switch(unit){
 			case 'us':
-				return val * BigInt(1e3);
+				return val * 1e3;
 				break;
 
 			case 'ms':
-				return val * BigInt(1e6);
+				return val * 1e6;
 				break;
 
 			case 's':
-				return val * BigInt(1e9);
+				return val * 1e9;
 				break;
 
 			default:
@@ -408,6 +636,36 @@ class ECAT extends EventEmitter{
 		_config.interval = self._toNanoseconds(val, unit);
 	}
 
+	/**
+	 *	set bound and policy of cycle data queue, must be called before start().
+	 *	Policy decides what happens when JS can't keep up with cyclic task:
+	 *		- drop-oldest: oldest undelivered cycle is replaced with the new one,
+	 *		default
+	 *		- drop-newest: new cycle is discarded
+	 *		- coalesce: only the latest cycle is kept, capacity is ignored
+	 *		- block: cyclic task waits until there is free slot. Frames aren't
+	 *		sent or received meanwhile, so bus I/O pauses while JS is behind
+	 *	@param {number} capacity - max number of undelivered cycles
+	 *	@param {('drop-oldest'|'drop-newest'|'coalesce'|'block')} policy - queue policy
+	 * 	@example etherlab.setQueuePolicy(8, 'drop-oldest');
+	 * */
+	setQueuePolicy(capacity, policy = 'drop-oldest'){
+		if(isNaN(capacity) || !Number.isInteger(capacity) || capacity <= 0){
+			throw `Capacity must be an integer and greater than 0`;
+		}
+
+		return ecat.setQueuePolicy(capacity, policy);
+	}
+
+	/**
+	 *	get cycle data queue statistics
+	 * 	@returns {Object} queue capacity, pending, delivered, dropped and coalesced cycles
+	 * 	@example etherlab.getQueueStats();
+	 * */
+	getQueueStats(){
+		return ecat.getQueueStats();
+	}
+
 	/**
 	 *	get allocated domain
 	 * 	@returns {Promise<Object>} allocated domain
@@ -418,13 +676,18 @@ class ECAT extends EventEmitter{
 	}
 
 	/**
-	 *	get calculated latency and jitter
-	 * 	@returns {Object} latency and jitter
+	 *	get moving average of cycle timing, calculated natively on every callback
+	 *		- latency: interval between delivered cycles, by their end of cycle
+	 *		time, so cycles queued while callback is busy aren't counted as 0
+	 *		- jitter: interval difference between consecutive cycles
+	 *		- delivery: time from end of cyclic task until callback is called
+	 *		- processing: execution time of the callback
+	 * 	@returns {Object} latency, jitter, delivery and processing time
 	 * 	@example etherlab.getLatencyAndJitter('us');
 	 * */
 	getLatencyAndJitter(unit = 'us'){
 		const self = this;
-		const values = _average.values;
+		const values = ecat.getCycleTiming();
 
 		for(const key in values){
 			values[key] = self.fromNanoseconds(values[key], unit);
@@ -433,6 +696,37 @@ class ECAT extends EventEmitter{
 		return {...values, unit};
 	}
 
+	/**
+	 *	get duration of each phase of the last init() and start(), in the
+	 *	order they run. Phases which haven't run yet are null:
+	 *		- configureSlaves: parsing configuration or loading it from cache
+	 *		- initSlave: copying configured slaves into the ones used by master
+	 *		- slaveConfig: slave configurations
+	 *		- syncManagerConfig: SMs and PDOs
+	 *		- parametersConfig: startup SDOs
+	 *		- domainConfig: domain registrations
+	 *		- domainRegistration: registering PDO entries into domain
+	 *		- masterActivation: activating master
+	 *		- operational: from activation until all slaves are OP, measured
+	 *		on the first cycle they are
+	 * 	@returns {Object} { phases, total, isOperational, unit }
+	 * 	@example etherlab.getStartupReport('ms');
+	 * */
+	getStartupReport(unit = 'ms'){
+		const self = this;
+		const report = ecat.getStartupReport();
+
+		for(const phase in report.phases){
+			if(report.phases[phase] !== null){
+				report.phases[phase] = self.fromNanoseconds(report.phases[phase], unit);
+			}
+		}
+
+		report.total = self.fromNanoseconds(report.total, unit);
+
+		return {...report, unit};
+	}
+
 	/**
 	 *	get current ethercat master state
 	 * 	@returns {number} master state
@@ -476,15 +770,17 @@ class ECAT extends EventEmitter{
 	}
 
 	/**
-	 *	Read SDO value
-	 *	Will throw error if SDO doesn't exist
+	 *	Read SDO value asynchronously
+	 *	The request is queued and progressed by native thread,
+	 *	so multiple requests can be in flight at the same time.
+	 *	Promise will be rejected if SDO request failed or timed out
 	 *	@param {number} position - slave position
 	 *	@param {number} index - SDO index
 	 *	@param {number} subindex - SDO subindex
 	 *	@param {string} type - SDO type
 	 *	@param {number} [timeout=100] - timeout in ms
-	 * 	@returns {number} SDO value
-	 * 	@example const domain = etherlab.sdoRead(3, 0x1c32, 0x1);
+	 * 	@returns {Promise<number>} SDO value
+	 * 	@example const value = await etherlab.sdoRead(3, 0x1c32, 0x1, 'uint16');
 	 * */
 	sdoRead(position, index, subindex, type, opts = {}){
 		const self = this;
@@ -505,16 +801,18 @@ class ECAT extends EventEmitter{
 	}
 
 	/**
-	 *	Write SDO value
-	 *	Will throw error if SDO doesn't exist
-	 *	@param {number} value - value to write
+	 *	Write SDO value asynchronously
+	 *	The request is queued and progressed by native thread,
+	 *	so multiple requests can be in flight at the same time.
+	 *	Promise will be rejected if SDO request failed or timed out
 	 *	@param {number} position - slave position
 	 *	@param {number} index - SDO index
 	 *	@param {number} subindex - SDO subindex
 	 *	@param {string} type - SDO type
+	 *	@param {number} value - value to write
 	 *	@param {number} [timeout=100] - timeout in ms
-	 * 	@returns {number} SDO value
-	 * 	@example const domain = etherlab.sdoRead(3, 0x1c32, 0x1);
+	 * 	@returns {Promise<number>} written SDO value
+	 * 	@example await etherlab.sdoWrite(3, 0x8000, 0x04, 'uint32', 0x55);
 	 * */
 	sdoWrite(position, index, subindex, type, value, opts = {}){
 		const self = this;
@@ -0,0 +1,42 @@
+const { Worker, isMainThread, parentPort } = require('worker_threads');
+
+// EtherCAT master is owned by the worker, cyclic data is handled there
+// and only the values needed by main thread are posted back.
+if(isMainThread){
+	const worker = new Worker(__filename);
+
+	worker.on('message', message => {
+		console.log(message);
+	});
+
+	worker.on('error', error => {
+		console.error(error);
+	});
+
+	// main event loop is free for other tasks
+	setInterval(() => {
+		worker.postMessage({ index: 0, value: Date.now() & 0xfff });
+	}, 100);
+} else {
+	const __etherlab = require('..');
+
+	const config = __dirname + '/slaves.sample.json';
+	const frequency = 2500;
+
+	const etherlab = new __etherlab(config, frequency);
+
+	etherlab.on('ready', async () => {
+		parentPort.postMessage({ ready: true });
+	});
+
+	etherlab.on('data', data => {
+		parentPort.postMessage({ data });
+	});
+
+	parentPort.on('message', ({ index, value }) => {
+		etherlab.writeIndex(index, value);
+	});
+
+	etherlab.setInterval(100, 'ms');
+	etherlab.start();
+}
@@ -9,16 +9,30 @@
 #include <unistd.h>
 
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
 #include <stdexcept>
 #include <chrono>
 #include <thread>
 #include <vector>
-#include <map>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include <napi.h>
 
 #include "ecrt.h"
 #include "include/config_parser.h"
+#include "include/bus_scanner.h"
+#include "include/esi_parser.h"
+#include "include/config_diff.h"
+#include "include/pdo_config.h"
+#include "include/capacity_planner.h"
+#include "include/moving_average.h"
 
 /****************************************************************************/
 #define MAX_SAFE_STACK (8 * 1024) /* The maximum stack size which is
@@ -37,6 +51,27 @@
 
 #define MASTER_STATE_DETAIL(_BIT, _state) ((_state >> _BIT) & 0x01)
 
+/** Number of samples in cycle timing moving averages. */
+#define TIMING_WINDOW 10
+
+/** Default number of cycle snapshots waiting to be delivered to JS. */
+#define CYCLE_QUEUE_CAPACITY 16
+
+/** Duration of startup phase which hasn't run or completed yet. */
+#define STARTUP_PHASE_NONE -1
+
+/** Slave position without configured slave, see slave_indexes. */
+#define SLAVE_INDEX_NONE -1
+
+/** SDO requests polling period in ns. */
+#define SDO_POLL_PERIOD_NS 1000000
+
+/** Maximum nesting of slave configuration passed as JS object. */
+#define JS_CONFIG_MAX_DEPTH 32
+
+/** Largest integer a JS number holds exactly. */
+#define MAX_SAFE_INTEGER 9007199254740991.0
+
 /****************************************************************************/
 
 // EtherCAT
@@ -51,6 +86,9 @@ static io_size_et DomainN_length;
 // process data
 static uint8_t *DomainN_pd = NULL;
 
+// sequence counter of IOs values, odd while cyclic task is updating them
+static std::atomic<uint32_t> IOs_seq(0);
+
 struct timespec epoch;
 
 #if DEBUG > 0
@@ -59,44 +97,196 @@ struct timespec start, end;
 
 static uint32_t counter = 0;
 static int8_t _running_state = -1;
-static int8_t isMasterReady = -1;
+static std::atomic<int8_t> isMasterReady(-1);
 
-// slave configurations
+// slave configurations. Tables below are also read by SDO thread, changes of
+// slaves, sc_slaves and slave_indexes and slave state checks are done with
+// slaves_mutex held.
+static std::mutex slaves_mutex;
 static std::vector<ec_slave_config_t*> sc_slaves;
 
 static std::vector<slaveConfig> slaves;
 static slave_size_et slaves_length = 0;
 
+// index into slaves and sc_slaves by slave position, SLAVE_INDEX_NONE if
+// there's no slave configured at that position
+static std::vector<int32_t> slave_indexes;
+inline static int32_t _slave_index(ecat_pos_al position);
+
+// operational state of each slave, 1 bit per slave, and aggregate of all
+// slaves. Updated by check_slave_config_states(), read on every access.
+static std::vector<uint64_t> slaves_operational;
+static std::atomic<uint8_t> all_slaves_operational(1);
+
 static std::vector<slaveEntry> IOs;
 static io_size_et IOs_length = 0;
 
+// engineering values of IOs, calculated in one pass after decoding
+static bool IOs_is_scaled = false;
+static std::vector<double> IOs_numeric;
+static std::vector<double> IOs_scale;
+static std::vector<double> IOs_scale_offset;
+static std::vector<double> IOs_scaled;
+
 static std::vector<slaveEntry> slave_entries;
 static slave_size_et slave_entries_length = 0;
 
 static std::vector<startupConfig> startup_parameters;
 static sparam_size_et startup_parameters_length = 0;
 
-// SM startup config
-inline static uint32_t _convert_index_sub_size(ecat_index_al index,
-	ecat_sub_al subindex, ecat_size_al size);
+// string and octets values of startup parameters, see startupConfig.data_offset
+static std::vector<uint8_t> startup_parameter_data;
+
+// entry names from slave configuration, referenced by slaveEntry.name_id
+static std::vector<std::string> entry_names;
 
-// mapped domain
-static std::map<uint32_t, io_size_et> mapped_domains;
-inline static uint32_t _convert_pos_index_sub(const ecat_pos_al& s_position,
-	const ecat_index_al& s_index, const ecat_sub_al& s_subindex);
+// mapped domain, CSR-like layout: keys of slave at position p are
+// mapped_keys[mapped_ranges[p] .. mapped_ranges[p + 1]], sorted by key
+static std::vector<uint32_t> mapped_ranges;
+static std::vector<uint32_t> mapped_keys;
+static std::vector<io_size_et> mapped_indexes;
+inline static uint32_t _convert_index_sub(const ecat_index_al& s_index,
+	const ecat_sub_al& s_subindex);
 static io_size_et get_domain_index(io_size_et* dmn_idx,
 	const ecat_pos_al& s_position, const ecat_index_al& s_index,
 	const ecat_sub_al& s_subindex);
+
+// named domain, sorted by name for binary search
+struct namedDomain {
+	const std::string* name;
+	io_size_et dmn_idx;
+};
+
+static std::vector<namedDomain> named_domains;
+void assign_domain_names();
+static io_size_et get_named_domain_index(io_size_et* dmn_idx, const std::string& name);
 void assign_domain_identifier();
 
 // Periodic task timing
 static uint16_t FREQUENCY = 1000;
 static uint32_t PERIOD_NS = NSEC_PER_SEC / FREQUENCY;
 
+// cycle timing, sampled on JS thread on every callback
+struct cycleTiming {
+	int64_t last_timestamp_ns; // end of last delivered cycle, 0 if not in OP
+	int64_t last_interval_ns;
+
+	movingAverage<TIMING_WINDOW> latency; // interval between delivered cycles
+	movingAverage<TIMING_WINDOW> jitter; // interval difference between cycles
+	movingAverage<TIMING_WINDOW> delivery; // cycle end until callback starts
+	movingAverage<TIMING_WINDOW> processing; // JS callback execution time
+};
+
+static cycleTiming cycle_timing = {};
+
+// startup phases of init() and start(), in the order they run
+typedef enum startup_phase_en{
+	PHASE_CONFIGURE_SLAVES = 0, // parse configuration or load it from cache
+	PHASE_INIT_SLAVE, // copy configured slaves into the ones used by master
+	PHASE_SLAVE_CONFIG, // slave configurations
+	PHASE_SYNCMANAGER_CONFIG, // SMs and PDOs
+	PHASE_PARAMETERS_CONFIG, // startup SDOs
+	PHASE_DOMAIN_CONFIG, // domain registrations
+	PHASE_DOMAIN_REGISTRATION, // ecrt_domain_reg_pdo_entry_list()
+	PHASE_MASTER_ACTIVATION, // ecrt_master_activate()
+	PHASE_OPERATIONAL, // activation until all slaves are OP
+	PHASE_COUNT
+} startup_phase_al;
+
+static const char *startup_phase_names[PHASE_COUNT] = {
+	"configureSlaves",
+	"initSlave",
+	"slaveConfig",
+	"syncManagerConfig",
+	"parametersConfig",
+	"domainConfig",
+	"domainRegistration",
+	"masterActivation",
+	"operational"
+};
+
+// duration of each phase of the last startup in ns, STARTUP_PHASE_NONE if
+// it hasn't run. Phases may run on cyclic task, report is read on JS thread.
+static std::atomic<int64_t> startup_phases[PHASE_COUNT];
+static std::atomic<int64_t> master_activated_ns(0); // 0 if not activated
+
+// what to do with new cycle data when JS can't keep up
+typedef enum queue_policy_en{
+	QUEUE_BLOCK = 0, // cyclic task waits until there is free slot, bus I/O pauses
+	QUEUE_DROP_OLDEST = 1, // oldest undelivered cycle is replaced
+	QUEUE_DROP_NEWEST = 2, // new cycle is discarded
+	QUEUE_COALESCE = 3 // only latest cycle is kept
+} queue_policy_al;
+
+// domain values of one cycle
+struct cycleSnapshot {
+	std::vector<ecat_value_al> values;
+	std::vector<double> scaled;
+	uint8_t al_states;
+	int64_t timestamp_ns;
+};
+
+// bounded ring of cycle snapshots, filled by cyclic task and drained on JS thread
+struct cycleQueue {
+	std::mutex mutex;
+	std::condition_variable not_full;
+
+	std::vector<cycleSnapshot> slots;
+	size_t head;
+	size_t count;
+	size_t capacity;
+	queue_policy_al policy;
+
+	// set when a drain call is queued into TSFN, to avoid flooding TSFN queue
+	std::atomic<bool> notify_pending;
+
+	uint64_t delivered;
+	uint64_t dropped;
+	uint64_t coalesced;
+};
+
+static cycleQueue cycle_queue;
+static size_t cycle_queue_capacity = CYCLE_QUEUE_CAPACITY;
+static queue_policy_al cycle_queue_policy = QUEUE_DROP_OLDEST;
+
+// snapshot being delivered to JS, owned by JS thread
+static cycleSnapshot js_snapshot;
+
 // configuration
-static std::string json_path;
+// parsed slave configuration, master is re-initialized from it after stop.
+// Only changed on JS thread, with configured_mutex held as re-initialization
+// copies it on cyclic task.
+static std::mutex configured_mutex;
+static bool is_slave_configured = false;
+static std::vector<slaveEntry> configured_entries;
+static std::vector<startupConfig> configured_parameters;
+static std::vector<uint8_t> configured_parameter_data;
+static std::vector<std::string> configured_names;
+
+// set while cyclic task re-initializes master from configured slaves
+static std::atomic<bool> is_reinitializing(false);
+
+// parameters applied by reconfigure(), committed to configured parameters
+// once every SDO write of them succeeded
+struct pendingParameters {
+	bool is_pending;
+	bool is_failed;
+	size_t writes; // unsettled SDO writes
+	std::vector<startupConfig> parameters;
+	std::vector<uint8_t> parameter_data;
+};
+
+static pendingParameters pending_parameters;
+
+static std::string schema_json; // empty if configuration is not validated
+static std::string cache_path; // empty if configuration is not cached
+static std::vector<std::string> esi_paths; // empty if ESI files are not used
 static bool do_sort_slave;
 
+struct TsfnContext;
+void drain_cycles(Napi::Env env, Napi::Function jsCallback, TsfnContext *context,
+	void *data);
+
 // Data structure representing our thread-safe function context.
 struct TsfnContext {
 	TsfnContext(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {};
@@ -107,9 +297,108 @@ struct TsfnContext {
 	// Native thread
 	std::thread nativeThread;
 
+	// calls drain_cycles() without data, so cyclic task doesn't allocate
+	// a callback wrapper on every notification
+	Napi::TypedThreadSafeFunction<TsfnContext, void, drain_cycles> tsfn;
+};
+
+// Queued SDO request, settled through its Promise once finished
+struct SdoJob {
+	SdoJob(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {};
+
+	// Native Promise returned to JavaScript
+	Napi::Promise::Deferred deferred;
+
+	sdo_req_type_al rtype;
+	ecat_pos_al position;
+	ecat_index_al index;
+	ecat_sub_al subindex;
+	ecat_size_al size;
+	uint32_t timeout = 100;
+	uint8_t verbosity = 0;
+
+	Unit32b data = {};
+
+	ec_sdo_request_t *req = NULL;
+	struct timespec started = {};
+	int8_t status = 0;
+
+	bool is_reconfigure = false; // writes parameter of pending_parameters
+};
+
+// SDO thread context, thread is alive as long as there are SDO jobs
+struct SdoContext {
+	// Native thread
+	std::thread nativeThread;
+
 	Napi::ThreadSafeFunction tsfn;
 };
 
+// SDO requests waiting to be picked up by SDO thread
+static std::mutex sdo_mutex;
+static std::deque<SdoJob*> sdo_queue;
+static bool sdo_thread_running = false;
+
+// set while master is released, SDO thread rejects every job it holds and
+// no new job is accepted
+static bool sdo_cancelling = false;
+static std::condition_variable sdo_idle;
+
+// Per-environment addon data. Addon can be loaded by main thread and workers,
+// but EtherCAT master is process-wide, so only one environment may own it.
+struct AddonData {
+	uint32_t id;
+};
+
+#define MASTER_OWNER_NONE 0
+#define MASTER_OWNER_ORPHANED UINT32_MAX
+
+#define MASTER_OWNER_ERROR "EtherCAT master is owned by another thread!"
+
+// owner is compared without lock on every access, mutex is only taken to
+// claim or release it
+static std::mutex master_owner_mutex;
+static std::atomic<uint32_t> addon_data_counter(0);
+static std::atomic<uint32_t> master_owner(MASTER_OWNER_NONE);
+
+// id of environment running on this thread, every environment has its own thread
+static thread_local uint32_t env_id = MASTER_OWNER_NONE;
+
+/*****************************************************************************/
+
+inline static int64_t monotonic_ns()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (int64_t) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+void reset_startup_phases()
+{
+	for(uint8_t phase = 0; phase < PHASE_COUNT; phase++){
+		startup_phases[phase].store(STARTUP_PHASE_NONE, std::memory_order_relaxed);
+	}
+
+	master_activated_ns.store(0, std::memory_order_relaxed);
+}
+
+inline static void end_startup_phase(startup_phase_al phase, int64_t started_ns)
+{
+	startup_phases[phase].store(monotonic_ns() - started_ns, std::memory_order_relaxed);
+}
+
+void reset_cycle_timing()
+{
+	cycle_timing.last_timestamp_ns = 0;
+	cycle_timing.last_interval_ns = 0;
+
+	cycle_timing.latency.reset();
+	cycle_timing.jitter.reset();
+	cycle_timing.delivery.reset();
+	cycle_timing.processing.reset();
+}
+
 /*****************************************************************************/
 
 void check_domain_state(void)
@@ -179,6 +468,8 @@ void check_master_state(ec_master_t *master)
 
 void check_slave_config_states(void)
 {
+	std::lock_guard<std::mutex> lock(slaves_mutex);
+
 	for(slave_size_et slNumber = 0; slNumber < slaves_length; slNumber++){
 		ec_slave_config_state_t s;
 
@@ -217,65 +508,376 @@ void check_slave_config_states(void)
 #endif
 
 		slaves[slNumber].state = s;
+
+		uint64_t bit = 1ULL << (slNumber % 64);
+		if(s.operational){
+			slaves_operational[slNumber / 64] |= bit;
+		} else {
+			slaves_operational[slNumber / 64] &= ~bit;
+		}
+	}
+
+	// all bits of complete words are set, remaining bits of last word
+	uint8_t is_operational = 1;
+	slave_size_et full_words = slaves_length / 64;
+
+	for(slave_size_et i_word = 0; i_word < full_words; i_word++){
+		if(slaves_operational[i_word] != ~0ULL){
+			is_operational = 0;
+			break;
+		}
+	}
+
+	if(is_operational && slaves_length % 64){
+		is_operational = slaves_operational[full_words] == mask(slaves_length % 64);
 	}
+
+	all_slaves_operational.store(is_operational, std::memory_order_release);
 }
 
 uint8_t check_is_operational()
 {
-	for(slave_size_et slNumber = 0; slNumber < slaves_length; slNumber++){
-		if(!slaves[slNumber].state.operational){
-			return 0;
+	return all_slaves_operational.load(std::memory_order_acquire);
+}
+
+// read 'size' bits starting at 'bit_position' of little endian data
+inline static uint64_t read_bits(const uint8_t *data, uint8_t bit_position, uint8_t size)
+{
+	uint8_t n_bytes = (bit_position + size + 7) / 8;
+	uint64_t raw = 0;
+
+	for(uint8_t i_byte = 0; i_byte < n_bytes && i_byte < 8; i_byte++){
+		raw |= (uint64_t) data[i_byte] << (8 * i_byte);
+	}
+
+	raw >>= bit_position;
+
+	// 64 bits value which doesn't start at bit 0 spans over 9 bytes
+	if(n_bytes > 8){
+		raw |= (uint64_t) data[8] << (64 - bit_position);
+	}
+
+	return raw & mask(size);
+}
+
+// write 'size' bits starting at 'bit_position' of little endian data,
+// other bits are preserved
+inline static void write_bits(uint8_t *data, uint8_t bit_position, uint8_t size,
+	uint64_t value)
+{
+	uint8_t n_bytes = (bit_position + size + 7) / 8;
+	uint64_t value_mask = mask(size);
+
+	value &= value_mask;
+
+	for(uint8_t i_byte = 0; i_byte < n_bytes && i_byte < 8; i_byte++){
+		uint8_t shift = 8 * i_byte;
+
+		uint8_t byte_mask = (uint8_t) (shift >= bit_position
+								? value_mask >> (shift - bit_position)
+								: value_mask << (bit_position - shift));
+		uint8_t byte_value = (uint8_t) (shift >= bit_position
+								? value >> (shift - bit_position)
+								: value << (bit_position - shift));
+
+		data[i_byte] = (data[i_byte] & ~byte_mask) | (byte_value & byte_mask);
+	}
+
+	if(n_bytes > 8){
+		uint8_t byte_mask = (uint8_t) (value_mask >> (64 - bit_position));
+		uint8_t byte_value = (uint8_t) (value >> (64 - bit_position));
+
+		data[8] = (data[8] & ~byte_mask) | (byte_value & byte_mask);
+	}
+}
+
+inline static int64_t sign_extend(uint64_t raw, uint8_t size)
+{
+	if(size >= 64){
+		return (int64_t) raw;
+	}
+
+	uint64_t sign_bit = 1ULL << (size - 1);
+
+	return (int64_t) ((raw ^ sign_bit) - sign_bit);
+}
+
+// decode raw value of entry from process data
+inline static ecat_value_al decode_entry_value(const slaveEntry& io)
+{
+	uint8_t *data = DomainN_pd + io.offset;
+
+	if(io.bit_position == 0){
+		switch(io.size){
+			// No endian difference for 1 byte variable
+			case 8:
+				return EC_READ_U8(data);
+
+			case 16:
+				return io.SWAP_ENDIAN
+						? swap_endian16(EC_READ_U16(data))
+						: EC_READ_U16(data);
+
+			case 32:
+				return io.SWAP_ENDIAN
+						? swap_endian32(EC_READ_U32(data))
+						: EC_READ_U32(data);
+
+			case 64:
+				return io.SWAP_ENDIAN
+						? swap_endian64(EC_READ_U64(data))
+						: EC_READ_U64(data);
+		}
+	}
+
+	// No endian difference for 1 bit variable and bit strings
+	if(io.size == 1){
+		return EC_READ_BIT(data, io.bit_position);
+	}
+
+	ecat_value_al value = read_bits(data, io.bit_position, io.size);
+
+	// only 16, 32 and 64 bits entries may swap endian, see parser
+	if(io.SWAP_ENDIAN){
+		switch(io.size){
+			case 16: return swap_endian16(value);
+			case 32: return swap_endian32(value);
+			case 64: return swap_endian64(value);
 		}
 	}
 
-	return 1;
+	return value;
 }
 
-int8_t write_output_value(io_size_et dmn_idx, ecat_value_al value, uint8_t SIGNED)
+// encode raw value of entry into process data
+inline static void encode_entry_value(const slaveEntry& io, ecat_value_al value)
 {
-	// selected index is not output, return immediately
-	if(IOs[dmn_idx].direction != EC_DIR_OUTPUT){
-		return -1;
+	uint8_t *data = DomainN_pd + io.offset;
+
+	if(io.bit_position == 0){
+		switch(io.size){
+			case 8:
+				EC_WRITE_U8(data, (uint8_t) value);
+				return;
+
+			case 16:
+				EC_WRITE_U16(data, io.SWAP_ENDIAN
+										? swap_endian16(value)
+										: (uint16_t) value);
+				return;
+
+			case 32:
+				EC_WRITE_U32(data, io.SWAP_ENDIAN
+										? swap_endian32(value)
+										: (uint32_t) value);
+				return;
+
+			case 64:
+				EC_WRITE_U64(data, io.SWAP_ENDIAN
+										? swap_endian64(value)
+										: value);
+				return;
+		}
 	}
 
-	switch(IOs[dmn_idx].size){
-		case 1:
-			EC_WRITE_BIT(
-					DomainN_pd + IOs[dmn_idx].offset,
-					IOs[dmn_idx].bit_position,
-					(uint8_t) value & 0x1
-				);
-			return 1;
-			break;
+	if(io.size == 1){
+		EC_WRITE_BIT(data, io.bit_position, (uint8_t) value & 0x1);
+		return;
+	}
 
-		case 8:
-			if(SIGNED)
-				EC_WRITE_S8(DomainN_pd + IOs[dmn_idx].offset, (int8_t) value);
-			else
-				EC_WRITE_U8(DomainN_pd + IOs[dmn_idx].offset, (uint8_t) value);
-			break;
+	if(io.SWAP_ENDIAN){
+		switch(io.size){
+			case 16: value = swap_endian16(value); break;
+			case 32: value = swap_endian32(value); break;
+			case 64: value = swap_endian64(value); break;
+		}
+	}
 
-		case 16:
-			if(SIGNED)
-				EC_WRITE_S16(DomainN_pd + IOs[dmn_idx].offset, (int16_t) value);
-			else
-				EC_WRITE_U16(DomainN_pd + IOs[dmn_idx].offset, (uint16_t) value);
-			break;
+	write_bits(data, io.bit_position, io.size, value);
+}
+
+// convert raw value to number, integer wider than 53 bits may lose precision
+inline static double entry_value_to_double(const slaveEntry& io, ecat_value_al raw)
+{
+	switch(io.type){
+		case ECAT_TYPE_REAL32: {
+			uint32_t bits = (uint32_t) raw;
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
 
-		case 32:
-			if(SIGNED)
-				EC_WRITE_S32(DomainN_pd + IOs[dmn_idx].offset, (int32_t) value);
-			else
-				EC_WRITE_U32(DomainN_pd + IOs[dmn_idx].offset, (uint32_t) value);
+		case ECAT_TYPE_REAL64: {
+			double value;
+			memcpy(&value, &raw, sizeof(value));
+			return value;
+		}
 
-			break;
+		case ECAT_TYPE_INT:
+			return (double) sign_extend(raw, io.size);
 
 		default:
-			return 0;
-			break;
+			return (double) raw;
+	}
+}
+
+// convert raw value to JS value, integer wider than 32 bits is passed as BigInt
+Napi::Value entry_value_to_js(Napi::Env env, const slaveEntry& io, ecat_value_al raw)
+{
+	if(io.size > 32 && io.type != ECAT_TYPE_REAL64){
+		if(io.type == ECAT_TYPE_INT){
+			return Napi::BigInt::New(env, (int64_t) sign_extend(raw, io.size));
+		}
+
+		return Napi::BigInt::New(env, (uint64_t) raw);
+	}
+
+	return Napi::Number::New(env, entry_value_to_double(io, raw));
+}
+
+bool entry_value_from_double(const slaveEntry& io, double number, ecat_value_al *raw);
+
+// convert JS Number or BigInt into raw value of entry, false if Number
+// can't be held by integer entry
+bool entry_value_from_js(const slaveEntry& io, const Napi::Value& value,
+	ecat_value_al *raw)
+{
+	bool lossless;
+
+	if(value.IsBigInt()){
+		*raw = io.type == ECAT_TYPE_INT
+				? (ecat_value_al) value.As<Napi::BigInt>().Int64Value(&lossless)
+				: value.As<Napi::BigInt>().Uint64Value(&lossless);
+
+		*raw &= mask(io.size);
+		return true;
+	}
+
+	return entry_value_from_double(io, value.As<Napi::Number>().DoubleValue(), raw);
+}
+
+// truncate number towards zero into 64 bits. Converting double out of range
+// of integer type is undefined, so it's clamped to int64_t range first, or to
+// uint64_t range for unsigned values above it. Negative values wrap around.
+inline static ecat_value_al double_to_raw(double number, bool is_signed)
+{
+	if(number >= 18446744073709551616.0){
+		return is_signed ? (ecat_value_al) INT64_MAX : UINT64_MAX;
+	}
+
+	if(number >= 9223372036854775808.0){
+		return is_signed ? (ecat_value_al) INT64_MAX : (ecat_value_al) number;
+	}
+
+	if(number < -9223372036854775808.0){
+		return (ecat_value_al) INT64_MIN;
+	}
+
+	return (ecat_value_al) (int64_t) number;
+}
+
+// convert number into raw value of entry, false if number is NaN or infinite
+// and entry is integer
+bool entry_value_from_double(const slaveEntry& io, double number, ecat_value_al *raw)
+{
+	switch(io.type){
+		case ECAT_TYPE_REAL32: {
+			float real = (float) number;
+			uint32_t bits;
+			memcpy(&bits, &real, sizeof(bits));
+			*raw = bits;
+			return true;
+		}
+
+		case ECAT_TYPE_REAL64:
+			memcpy(raw, &number, sizeof(*raw));
+			return true;
+	}
+
+	if(!std::isfinite(number)){
+		return false;
+	}
+
+	*raw = double_to_raw(number, io.type == ECAT_TYPE_INT) & mask(io.size);
+	return true;
+}
+
+// convert engineering value into raw value of entry, inverse of scaling
+bool entry_value_from_scaled(const slaveEntry& io, double scaled, ecat_value_al *raw)
+{
+	double number = (scaled - io.scale_offset) / io.scale;
+
+	// round to nearest for integer entries
+	if(io.type != ECAT_TYPE_REAL32 && io.type != ECAT_TYPE_REAL64){
+		number = std::round(number);
+	}
+
+	return entry_value_from_double(io, number, raw);
+}
+
+void assign_entry_scaling()
+{
+	IOs_is_scaled = false;
+
+	IOs_numeric.assign(IOs_length, 0);
+	IOs_scaled.assign(IOs_length, 0);
+	IOs_scale.resize(IOs_length);
+	IOs_scale_offset.resize(IOs_length);
+
+	for(io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
+		IOs_scale[dmn_idx] = IOs[dmn_idx].scale;
+		IOs_scale_offset[dmn_idx] = IOs[dmn_idx].scale_offset;
+
+		if(IOs[dmn_idx].scale != 1 || IOs[dmn_idx].scale_offset != 0){
+			IOs_is_scaled = true;
+		}
+	}
+}
+
+// engineering value = value * scale + offset, written as plain loop over
+// contiguous arrays so compiler can vectorize it
+inline static void scale_entry_values(io_size_et dmn_size)
+{
+	const double *numeric = IOs_numeric.data();
+	const double *scale = IOs_scale.data();
+	const double *scale_offset = IOs_scale_offset.data();
+	double *scaled = IOs_scaled.data();
+
+	for(io_size_et dmn_idx = 0; dmn_idx < dmn_size; dmn_idx++){
+		scaled[dmn_idx] = numeric[dmn_idx] * scale[dmn_idx] + scale_offset[dmn_idx];
+	}
+}
+
+// convert JS value into raw value of entry, Number of scaled entry is in
+// engineering unit
+bool entry_value_from_js_scaled(const slaveEntry& io, const Napi::Value& value,
+	ecat_value_al *raw)
+{
+	if((io.scale != 1 || io.scale_offset != 0) && value.IsNumber()){
+		return entry_value_from_scaled(io, value.As<Napi::Number>().DoubleValue(), raw);
 	}
 
-	return 1;
+	return entry_value_from_js(io, value, raw);
+}
+
+// thrown if Number can't be written into integer entry
+void throw_invalid_entry_value(Napi::Env env)
+{
+	Napi::TypeError::New(
+			env,
+			"Value of integer entry must be a finite number"
+		).ThrowAsJavaScriptException();
+}
+
+const char* entry_type_name(uint8_t type)
+{
+	switch(type){
+		case ECAT_TYPE_INT: return "int";
+		case ECAT_TYPE_REAL32: return "real32";
+		case ECAT_TYPE_REAL64: return "real64";
+		case ECAT_TYPE_BITS: return "bits";
+		default: return "uint";
+	}
 }
 
 void cyclic_task(ec_master_t *master, io_size_et dmn_size)
@@ -300,6 +902,24 @@ void cyclic_task(ec_master_t *master, io_size_et dmn_size)
 		check_slave_config_states();
 	}
 
+	// startup ends on the first cycle all slaves are OP. Master state is read
+	// on every cycle until then, its AL states are OR of all slave states, so
+	// OP only with all slaves responding means every slave is OP.
+	int64_t activated_ns = master_activated_ns.load(std::memory_order_relaxed);
+	if(activated_ns > 0
+		&& startup_phases[PHASE_OPERATIONAL].load(std::memory_order_relaxed) == STARTUP_PHASE_NONE
+	){
+		check_master_state(master);
+
+		if(MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+			&& (all_slaves_operational.load(std::memory_order_acquire)
+				|| (master_state.al_states == (1 << AL_BIT_OP)
+					&& master_state.slaves_responding >= slaves_length))
+		){
+			end_startup_phase(PHASE_OPERATIONAL, activated_ns);
+		}
+	}
+
 	// do nothing if master is not ready
 	if(MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)) {
 #if DEBUG > 1
@@ -312,65 +932,33 @@ void cyclic_task(ec_master_t *master, io_size_et dmn_size)
 		clock_gettime(CLOCK_MONOTONIC, &start);
 #endif
 
-		uint16_t tmp16;
-		uint32_t tmp32;
+		IOs_seq.fetch_add(1, std::memory_order_acq_rel);
 
 		for(io_size_et dmn_idx = 0; dmn_idx < dmn_size; dmn_idx++){
 			if(IOs[dmn_idx].direction == EC_DIR_OUTPUT){
-				write_output_value(
-						dmn_idx,
-						IOs[dmn_idx].writtenValue,
-						IOs[dmn_idx].SIGNED
-					);
+				encode_entry_value(IOs[dmn_idx], IOs[dmn_idx].writtenValue);
 			}
 
-			switch(IOs[dmn_idx].size){
-				// No endian difference for 1 bit variable
-				case 1:
-					IOs[dmn_idx].value = (uint32_t) EC_READ_BIT(
-											DomainN_pd + IOs[dmn_idx].offset,
-											IOs[dmn_idx].bit_position
-										);
-					break;
-
-				// No endian difference for 1 byte variable
-				case 8:
-					IOs[dmn_idx].value =
-						(uint32_t) EC_READ_U8(DomainN_pd + IOs[dmn_idx].offset);
-					break;
-
-				case 16:
-					tmp16 = EC_READ_U16(DomainN_pd + IOs[dmn_idx].offset);
-					IOs[dmn_idx].value = (uint32_t) IOs[dmn_idx].SWAP_ENDIAN
-											? swap_endian16(tmp16)
-											: tmp16;
-					break;
-
-				case 32:
-					tmp32 = EC_READ_U32(DomainN_pd + IOs[dmn_idx].offset);
-					IOs[dmn_idx].value = (uint32_t) IOs[dmn_idx].SWAP_ENDIAN
-											? swap_endian32(tmp32)
-											: tmp32;
-					break;
-
-				default:
-					tmp32 = (*((uint32_t *)(DomainN_pd + IOs[dmn_idx].offset)))
-							& mask(IOs[dmn_idx].size);
-
-					IOs[dmn_idx].value = (uint32_t) IOs[dmn_idx].SWAP_ENDIAN
-											? swap_endian32(tmp32)
-											: tmp32;
-					break;
+			IOs[dmn_idx].value = decode_entry_value(IOs[dmn_idx]);
+
+			if(IOs_is_scaled){
+				IOs_numeric[dmn_idx] = entry_value_to_double(IOs[dmn_idx], IOs[dmn_idx].value);
 			}
 
 #if DEBUG > 2
-			printf("Index %2d pos %d 0x%04x:%02x = %04x\n", dmn_idx,
+			printf("Index %2d pos %d 0x%04x:%02x = %04llx\n", dmn_idx,
 				IOs[dmn_idx].position, IOs[dmn_idx].index, IOs[dmn_idx].subindex,
-				IOs[dmn_idx].value);
+				(unsigned long long) IOs[dmn_idx].value);
 #endif
 
 		};
 
+		if(IOs_is_scaled){
+			scale_entry_values(dmn_size);
+		}
+
+		IOs_seq.fetch_add(1, std::memory_order_release);
+
 #if DEBUG > 2
 		printf("=====================\n");
 #endif
@@ -443,7 +1031,11 @@ void domain_startup_config(ec_pdo_entry_reg_t **DomainN_regs, io_size_et *dmn_si
 					slave_entries[slNumber].SWAP_ENDIAN,
 					slave_entries[slNumber].SIGNED,
 					slave_entries[slNumber].writtenValue,
-					slave_entries[slNumber].WATCHDOG_ENABLED
+					slave_entries[slNumber].WATCHDOG_ENABLED,
+					slave_entries[slNumber].type,
+					slave_entries[slNumber].scale,
+					slave_entries[slNumber].scale_offset,
+					slave_entries[slNumber].name_id
 				});
 
 			// register domain with IOs
@@ -476,187 +1068,81 @@ void domain_startup_config(ec_pdo_entry_reg_t **DomainN_regs, io_size_et *dmn_si
 	(*DomainN_regs)[(*dmn_size)] = {};
 }
 
-uint32_t _convert_index_sub_size(ecat_index_al index, ecat_sub_al subindex,
-	ecat_size_al size)
-{
-	return ((index & 0xffff) << 16) | ((subindex & 0xff) << 8) | (size & 0xff);
-}
-
 void syncmanager_startup_config()
 {
 #if DEBUG > 0
 	fprintf(stdout, "\nConfiguring SyncManager and Mapping PDOs...\n");
 #endif
 
-	slave_size_et length = slave_entries_length;
-
-	ecat_pos_al last_position = -1;
-	ecat_index_al last_pdo_index = -1;
-	uint32_t last_index_sub_size = -1;
-
-	uint8_t syncM_index = 0, last_syncM_index = -1;
-	ec_direction_t direction;
-	ec_watchdog_mode_t watchdog_mode;
-
-	ecat_pos_al current_position = -1;
-	ecat_index_al current_pdo_index = -1;
-	ecat_index_al current_index = -1;
-	ecat_sub_al current_subindex = -1;
+	// identical slaves share one layout, it's only built once. Master copies
+	// the layout, so it's not kept after configuration
+	pdoConfig pdo_config;
+	build_pdo_config(slave_entries, pdo_config);
 
-	uint32_t processed_index_sub_size = -1;
+	// slaves without PDO index use default configuration, they aren't listed
+	for(const auto& slave : pdo_config.slaves){
+		int32_t slNumber = _slave_index(slave.first);
+		const pdoLayout *layout = &pdo_config.layouts[slave.second];
 
-	// add every valid slave and configure sync manager
-	for(slave_size_et slNumber = 0; slNumber < length; slNumber++){
-		processed_index_sub_size = _convert_index_sub_size(
-										slave_entries[slNumber].index,
-										slave_entries[slNumber].subindex,
-										slave_entries[slNumber].size
-									);
-		syncM_index = slave_entries[slNumber].sync_index;
+		if(slNumber == SLAVE_INDEX_NONE){
+			continue;
+		}
 
 #if DEBUG > 0
-		printf("\nSlave%2d 0x%04x 0x%08x %02d-bits\n",
-				slave_entries[slNumber].position, slave_entries[slNumber].pdo_index,
-				processed_index_sub_size, slave_entries[slNumber].size);
+		printf("config SMs and PDOs                  : Slave%2d %2d SM(s) %2d PDO(s)\n",
+			slaves[slNumber].position, (int) layout->syncs.size() - 1,
+			(int) layout->pdos.size());
 #endif
 
-		// invalid pdo index use default configuration, continue to next index
-		if(last_position != slave_entries[slNumber].position
-			&& slave_entries[slNumber].pdo_index){
+		if(ecrt_slave_config_pdos(
+						sc_slaves[slNumber],
+						layout->syncs.size() - 1,
+						&layout->syncs[0]
+		)){
+			fprintf(stderr, "Failed to configure SMs and PDOs. Slave%2d\n",
+											slaves[slNumber].position);
+			exit(EXIT_FAILURE);
+		}
 
-			// reset last SM index when encountering new slave
-			last_syncM_index = -1;
+		// master keeps default mapping of PDOs without entries, clear it
+		for(const ec_pdo_info_t& pdo : layout->pdos){
+			if(pdo.n_entries == 0){
+				ecrt_slave_config_pdo_mapping_clear(sc_slaves[slNumber], pdo.index);
+			}
+		}
+	}
+}
 
-			direction = (ec_direction_t) slave_entries[slNumber].direction;
-			watchdog_mode = slave_entries[slNumber].WATCHDOG_ENABLED
-						? EC_WD_ENABLE
-						: EC_WD_DISABLE;
-			current_position = slave_entries[slNumber].position;
+inline static int32_t _slave_index(ecat_pos_al position)
+{
+	return position < slave_indexes.size()
+		? slave_indexes[position]
+		: SLAVE_INDEX_NONE;
+}
 
+void slave_startup_config(ec_master_t *master)
+{
 #if DEBUG > 0
-			printf("config SM                            : Slave%2d SM%d\n",
-												current_position, syncM_index);
+	fprintf(stdout, "\nConfiguring Slaves...\n");
 #endif
 
-			if(ecrt_slave_config_sync_manager(
-							sc_slaves[current_position],
-							syncM_index,
-							direction,
-							watchdog_mode
-			)){
-				fprintf(stderr, "Failed to configure SM. Slave%2d SM%d\n",
-												current_position, syncM_index);
-				exit(EXIT_FAILURE);
-			}
+	slave_size_et length = slave_entries_length;
 
-			last_position = current_position;
-		}
+	std::lock_guard<std::mutex> lock(slaves_mutex);
 
-		if(last_syncM_index != syncM_index && slave_entries[slNumber].pdo_index){
-			ecrt_slave_config_pdo_assign_clear(sc_slaves[current_position],
-				syncM_index);
+	// dense table, so every configured position is checked in O(1)
+	ecat_pos_al max_position = 0;
+	for(slave_size_et slNumber = 0; slNumber < length; slNumber++){
+		max_position = std::max(max_position, slave_entries[slNumber].position);
+	}
 
-			last_syncM_index = syncM_index;
-
-#if DEBUG > 0
-			printf("clear PDO assign                     : Slave%2d SM%d\n",
-												current_position, syncM_index);
-#endif
-		}
-
-		// invalid pdo index use default configuration, continue to next index
-		if(last_pdo_index != slave_entries[slNumber].pdo_index && slave_entries[slNumber].pdo_index){
-
-			current_pdo_index = slave_entries[slNumber].pdo_index;
-
-#if DEBUG > 0
-			printf("add PDO assign and clear PDO mapping : Slave%2d SM%d 0x%04x\n",
-							current_position, syncM_index, current_pdo_index);
-#endif
-
-			if(ecrt_slave_config_pdo_assign_add(
-									sc_slaves[current_position],
-									syncM_index,
-									current_pdo_index
-			)){
-				fprintf(stderr, "Failed to configure PDO assign. Slave%2d SM%d 0x%04x\n",
-							current_position, syncM_index, current_pdo_index);
-				exit(EXIT_FAILURE);
-			}
-
-			ecrt_slave_config_pdo_mapping_clear(
-								sc_slaves[current_position],
-								current_pdo_index
-							);
-
-			last_pdo_index = current_pdo_index;
-		}
-
-		// invalid pdo index use default configuration, continue to next index
-		if(last_index_sub_size != processed_index_sub_size
-				&& processed_index_sub_size
-		){
-			current_index = slave_entries[slNumber].index;
-			current_subindex = slave_entries[slNumber].subindex;
-
-#if DEBUG > 0
-			printf("add PDO mapping                      : Slave%2d SM%d 0x%4x 0x%04x:%02x %2d\n",
-				current_position, syncM_index, current_pdo_index, current_index,
-									current_subindex, slave_entries[slNumber].size);
-#endif
-
-			int8_t mapping = ecrt_slave_config_pdo_mapping_add(
-					sc_slaves[current_position],
-					current_pdo_index,
-					current_index,
-					current_subindex,
-					slave_entries[slNumber].size
-				);
-
-			if(mapping){
-				fprintf(stderr,
-					"Failed to add PDO mapping. Slave%2d SM%d 0x%4x 0x%04x:0x%02x %2d\n",
-					current_position, syncM_index, current_pdo_index,
-					current_index, current_subindex, slave_entries[slNumber].size);
-
-				exit(EXIT_FAILURE);
-			}
-
-			last_index_sub_size = _convert_index_sub_size(
-										slave_entries[slNumber].index,
-										slave_entries[slNumber].subindex,
-										slave_entries[slNumber].size
-									);
-		}
-	}
-}
-
-uint8_t _skip_current_slave_position(ecat_pos_al position,
-									std::vector<ecat_pos_al>& last_positions)
-{
-	for(slave_size_et slNumber = 0; slNumber < last_positions.size(); slNumber++){
-		if(position == last_positions[slNumber]){
-			return 1;
-		}
-	}
-
-	return 0;
-}
-
-void slave_startup_config(ec_master_t *master)
-{
-#if DEBUG > 0
-	fprintf(stdout, "\nConfiguring Slaves...\n");
-#endif
-
-	slave_size_et length = slave_entries_length;
-	std::vector<ecat_pos_al> last_positions;
+	slave_indexes.assign(length ? max_position + 1 : 0, SLAVE_INDEX_NONE);
+	slaves.reserve(length);
+	sc_slaves.reserve(length);
 
 	for(slave_size_et slNumber = 0; slNumber < length; slNumber++){
 		// skip current slave, if it's already configured
-		if(_skip_current_slave_position(
-				slave_entries[slNumber].position, last_positions)
-		){
+		if(slave_indexes[slave_entries[slNumber].position] != SLAVE_INDEX_NONE){
 			continue;
 		}
 
@@ -686,11 +1172,13 @@ void slave_startup_config(ec_master_t *master)
 				current.product_code
 			));
 
+		// save slave's index by its position
+		slave_indexes[current.position] = slaves_length;
+
 		// update number of slaves
 		slaves_length++;
-
-		// save last slave's position
-		last_positions.push_back(current.position);
+		slaves_operational.resize((slaves_length + 63) / 64, 0);
+		all_slaves_operational.store(0, std::memory_order_release);
 
 #if DEBUG > 0
 		printf("Current: Slave %2d %04x %04x %02x\n",
@@ -706,44 +1194,82 @@ void startup_parameters_config()
 	fprintf(stdout, "\nConfiguring Startup Parameters...\n");
 #endif
 
-	static sparam_size_et length = startup_parameters_length;
+	sparam_size_et length = startup_parameters.size();
 	for(sparam_size_et par_idx = 0; par_idx < length; par_idx++){
-		switch(startup_parameters[par_idx].size){
-			case 8:
-				ecrt_slave_config_sdo8(
-						sc_slaves[startup_parameters[par_idx].slavePosition],
-						startup_parameters[par_idx].index,
-						startup_parameters[par_idx].subindex,
-						(uint8_t) startup_parameters[par_idx].value
-					);
-				break;
+		const startupConfig& parameter = startup_parameters[par_idx];
+		int32_t slNumber = _slave_index(parameter.slavePosition);
 
-			case 16:
-				ecrt_slave_config_sdo16(
-						sc_slaves[startup_parameters[par_idx].slavePosition],
-						startup_parameters[par_idx].index,
-						startup_parameters[par_idx].subindex,
-						(uint16_t) startup_parameters[par_idx].value
-					);
-				break;
+		// parameters of slaves without entries aren't configured
+		if(slNumber == SLAVE_INDEX_NONE){
+			continue;
+		}
 
-			default:
-				ecrt_slave_config_sdo32(
-						sc_slaves[startup_parameters[par_idx].slavePosition],
-						startup_parameters[par_idx].index,
-						startup_parameters[par_idx].subindex,
-						(uint32_t) startup_parameters[par_idx].value
-					);
-				break;
+		int configured;
+
+		// value bytes of other than 8, 16 and 32 bits parameters
+		uint8_t value[sizeof(ecat_value_al)];
+		const uint8_t *data = value;
+		size_t data_size = parameter.size / 8;
+
+		if(parameter.data_offset != PARAM_DATA_NONE){
+			data = &startup_parameter_data[parameter.data_offset];
+			data_size = parameter.data_length;
+		} else {
+			EC_WRITE_U64(value, parameter.value);
+		}
+
+		if(parameter.complete_access){
+			configured = ecrt_slave_config_complete_sdo(
+					sc_slaves[slNumber],
+					parameter.index,
+					data,
+					data_size
+				);
+		} else if(parameter.data_offset == PARAM_DATA_NONE && parameter.size == 8){
+			configured = ecrt_slave_config_sdo8(
+					sc_slaves[slNumber],
+					parameter.index,
+					parameter.subindex,
+					(uint8_t) parameter.value
+				);
+		} else if(parameter.data_offset == PARAM_DATA_NONE && parameter.size == 16){
+			configured = ecrt_slave_config_sdo16(
+					sc_slaves[slNumber],
+					parameter.index,
+					parameter.subindex,
+					(uint16_t) parameter.value
+				);
+		} else if(parameter.data_offset == PARAM_DATA_NONE && parameter.size == 32){
+			configured = ecrt_slave_config_sdo32(
+					sc_slaves[slNumber],
+					parameter.index,
+					parameter.subindex,
+					(uint32_t) parameter.value
+				);
+		} else {
+			configured = ecrt_slave_config_sdo(
+					sc_slaves[slNumber],
+					parameter.index,
+					parameter.subindex,
+					data,
+					data_size
+				);
+		}
+
+		if(configured){
+			fprintf(stderr, "Failed to set Startup Parameter. Slave%2d 0x%04x:%02x\n",
+				parameter.slavePosition, parameter.index, parameter.subindex);
 		}
 
 #if DEBUG > 0
-		printf("Set Startup Parameter Slave%2d, 0x%04x:%02x = 0x%x (%d)\n",
-				startup_parameters[par_idx].slavePosition,
-				startup_parameters[par_idx].index,
-				startup_parameters[par_idx].subindex,
-				startup_parameters[par_idx].value,
-				startup_parameters[par_idx].value
+		printf("Set Startup Parameter Slave%2d, 0x%04x:%02x = 0x%llx (%llu), %zu byte(s)%s\n",
+				parameter.slavePosition,
+				parameter.index,
+				parameter.subindex,
+				(unsigned long long) parameter.value,
+				(unsigned long long) parameter.value,
+				data_size,
+				parameter.complete_access ? " complete access" : ""
 			);
 #endif
 
@@ -755,16 +1281,38 @@ void reset_global_vars(void)
 	IOs.clear();
 	IOs_length = 0;
 
-	slaves.clear();
-	slaves_length = 0;
+	IOs_is_scaled = false;
+	IOs_numeric.clear();
+	IOs_scale.clear();
+	IOs_scale_offset.clear();
+	IOs_scaled.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(slaves_mutex);
+
+		slaves.clear();
+		slaves_length = 0;
+
+		slaves_operational.clear();
+		all_slaves_operational.store(1, std::memory_order_release);
+
+		sc_slaves.clear();
+		slave_indexes.clear();
+	}
 
 	slave_entries.clear();
 	slave_entries_length = 0;
 
 	startup_parameters.clear();
 	startup_parameters_length = 0;
+	startup_parameter_data.clear();
 
-	sc_slaves.clear();
+	mapped_ranges.clear();
+	mapped_keys.clear();
+	mapped_indexes.clear();
+
+	named_domains.clear();
+	entry_names.clear();
 }
 
 /****************************************************************************/
@@ -790,88 +1338,441 @@ void assign_domain_identifier()
 	printf("\nAssigning Domain identifier...\n");
 #endif
 
+	mapped_ranges.clear();
+	mapped_keys.clear();
+	mapped_indexes.clear();
+
+	if(IOs_length <= 0){
+		return;
+	}
+
+	// order domains by position then key, latest domain wins on duplicate
+	std::vector<io_size_et> order(IOs_length);
 	for (io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
-		uint32_t identifier = _convert_pos_index_sub(
-				IOs[dmn_idx].position,
-				IOs[dmn_idx].index,
-				IOs[dmn_idx].subindex
-			);
+		order[dmn_idx] = dmn_idx;
+	}
+
+	std::sort(order.begin(), order.end(), [](io_size_et a, io_size_et b){
+			if(IOs[a].position != IOs[b].position){
+				return IOs[a].position < IOs[b].position;
+			}
+
+			uint32_t key_a = _convert_index_sub(IOs[a].index, IOs[a].subindex);
+			uint32_t key_b = _convert_index_sub(IOs[b].index, IOs[b].subindex);
+
+			return key_a != key_b ? key_a < key_b : a < b;
+		});
+
+	ecat_pos_al max_position = IOs[order.back()].position;
+	mapped_ranges.assign(max_position + 2, 0);
+	mapped_keys.reserve(IOs_length);
+	mapped_indexes.reserve(IOs_length);
+
+	for (io_size_et i_order = 0; i_order < IOs_length; i_order++){
+		const slaveEntry& io = IOs[order[i_order]];
+		uint32_t key = _convert_index_sub(io.index, io.subindex);
+
+		bool is_duplicate = i_order > 0
+							&& IOs[order[i_order - 1]].position == io.position
+							&& mapped_keys.back() == key;
+
+		if(is_duplicate){
+			mapped_indexes.back() = order[i_order];
+			continue;
+		}
+
+		mapped_keys.push_back(key);
+		mapped_indexes.push_back(order[i_order]);
+		mapped_ranges[io.position + 1]++;
+	}
+
+	// count per position into start offset per position
+	for (size_t i_pos = 1; i_pos < mapped_ranges.size(); i_pos++){
+		mapped_ranges[i_pos] += mapped_ranges[i_pos - 1];
+	}
+}
+
+void assign_domain_names()
+{
+	named_domains.clear();
+
+	for (io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
+		if(IOs[dmn_idx].name_id == ENTRY_NAME_NONE){
+			continue;
+		}
+
+		named_domains.push_back({ &entry_names[IOs[dmn_idx].name_id], dmn_idx });
+	}
+
+	std::sort(named_domains.begin(), named_domains.end(),
+		[](const namedDomain& a, const namedDomain& b){
+			return *a.name < *b.name;
+		});
+}
+
+static io_size_et get_named_domain_index(io_size_et* dmn_idx, const std::string& name)
+{
+	auto found = std::lower_bound(named_domains.begin(), named_domains.end(), name,
+		[](const namedDomain& a, const std::string& b){
+			return *a.name < b;
+		});
 
-		mapped_domains[identifier] = dmn_idx;
+	if(found == named_domains.end() || *found->name != name){
+		return -1;
 	}
+
+	*dmn_idx = found->dmn_idx;
+
+	return 0;
 }
 
-inline static uint32_t _convert_pos_index_sub(const ecat_pos_al& s_position,
-	const ecat_index_al& s_index, const ecat_sub_al& s_subindex)
+inline static uint32_t _convert_index_sub(const ecat_index_al& s_index,
+	const ecat_sub_al& s_subindex)
 {
-	return (s_position << 24) | (s_index << 8) | (s_subindex << 0);
+	return ((uint32_t) s_index << 8) | (s_subindex << 0);
 }
 
 static io_size_et get_domain_index(io_size_et* dmn_idx,
 	const ecat_pos_al& s_position, const ecat_index_al& s_index,
 	const ecat_sub_al& s_subindex)
 {
-	uint32_t key = _convert_pos_index_sub(s_position, s_index, s_subindex);
+	if((size_t) s_position + 1 >= mapped_ranges.size()){
+		return -1;
+	}
 
-	try {
-		*dmn_idx = mapped_domains.at(key);
-		return 0;
-	} catch (const std::out_of_range& err) {
-		fprintf(stderr, "Error %s: Index not found for pos %2d 0x%04x:%02x\n",
-			err.what(),
+	uint32_t key = _convert_index_sub(s_index, s_subindex);
+
+	auto first = mapped_keys.begin() + mapped_ranges[s_position];
+	auto last = mapped_keys.begin() + mapped_ranges[s_position + 1];
+	auto found = std::lower_bound(first, last, key);
+
+	if(found == last || *found != key){
+#if DEBUG > 0
+		fprintf(stderr, "Index not found for pos %2d 0x%04x:%02x\n",
 			s_position,
 			s_index,
 			s_subindex);
-
+#endif
 		return -1;
 	}
+
+	*dmn_idx = mapped_indexes[found - mapped_keys.begin()];
+
+	return 0;
 }
 
-int8_t write_domain(const ecat_pos_al& s_position,
-	const ecat_index_al& s_index, const ecat_sub_al& s_subindex,
-	const ecat_value_al& value)
+int8_t write_domain(const io_size_et& dmn_idx, const ecat_value_al& value)
 {
 	if(!check_is_operational()){
 		return -1;
 	}
 
-	io_size_et dmn_idx;
-	if(get_domain_index(&dmn_idx, s_position, s_index, s_subindex) < 0){
-		return -1;
-	}
-
 	IOs[dmn_idx].writtenValue = value;
 
 	return 0;
 }
 
-int8_t read_domain(const ecat_pos_al& s_position, const ecat_index_al& s_index,
-	const ecat_sub_al& s_subindex, ecat_value_al* value)
+int8_t read_domain(const io_size_et& dmn_idx, ecat_value_al* value)
 {
 	if(!check_is_operational()){
 		return -1;
 	}
 
-	io_size_et dmn_idx;
-	if(get_domain_index(&dmn_idx, s_position, s_index, s_subindex) < 0){
-		return -1;
-	}
-
 	*value = IOs[dmn_idx].value;
 
 	return 0;
 }
 
+// Slave configuration passed from JS. JSON text of Buffer is referenced
+// without copying it, JS object is walked directly without JSON round trip.
+struct jsConfig {
+	std::string text; /**< Copy of JS string. */
+	const char *json = NULL; /**< JSON text, NULL if configuration is object. */
+	size_t length = 0;
+	Napi::Value object;
+};
+
+// Walks JS value as configuration events, like JSON.stringify() would see it
+class jsConfigSource : public configEventSource {
+public:
+	explicit jsConfigSource(const Napi::Value& value) : root(value)
+	{
+		// own enumerable keys, inherited ones are skipped like JSON.stringify() does
+		object_keys = value.Env().Global().Get("Object").As<Napi::Object>()
+			.Get("keys").As<Napi::Function>();
+	}
+
+	bool emit(configEventSink& sink) override
+	{
+		return emit_value(sink, root);
+	}
+
+	std::string location() const override
+	{
+		std::string pointer = "'#";
+		for(const std::string& token : path){
+			pointer += "/" + token;
+		}
+
+		return pointer + "'";
+	}
+
+private:
+	Napi::Value root;
+	Napi::Function object_keys;
+	std::vector<std::string> path;
+
+	bool emit_value(configEventSink& sink, const Napi::Value& value)
+	{
+		if(path.size() > JS_CONFIG_MAX_DEPTH){
+			throw std::invalid_argument("Configuration is nested too deep");
+		}
+
+		if(value.IsEmpty()){
+			throw std::invalid_argument("Failed reading value");
+		}
+
+		if(value.IsNull() || value.IsUndefined()){
+			return sink.Null();
+		}
+
+		if(value.IsBoolean()){
+			return sink.Bool(value.As<Napi::Boolean>());
+		}
+
+		if(value.IsNumber()){
+			double number = value.As<Napi::Number>().DoubleValue();
+
+			// same as JSON.stringify()
+			if(!std::isfinite(number)){
+				return sink.Null();
+			}
+
+			// integers are passed as integers, like parsed from JSON text
+			if(number == std::floor(number) && std::fabs(number) <= MAX_SAFE_INTEGER){
+				return number < 0
+					? sink.Int64((int64_t) number)
+					: sink.Uint64((uint64_t) number);
+			}
+
+			return sink.Double(number);
+		}
+
+		if(value.IsString()){
+			std::string str = value.As<Napi::String>();
+
+			return sink.String(str.c_str(), str.size());
+		}
+
+		if(value.IsArray()){
+			Napi::Array array = value.As<Napi::Array>();
+			uint32_t length = array.Length();
+
+			if(!sink.StartArray()){
+				return false;
+			}
+
+			for(uint32_t i_item = 0; i_item < length; i_item++){
+				path.push_back(std::to_string(i_item));
+
+				if(!emit_value(sink, array.Get(i_item))){
+					return false;
+				}
+
+				path.pop_back();
+			}
+
+			return sink.EndArray(length);
+		}
+
+		if(value.IsObject() && !value.IsFunction()){
+			Napi::Object object = value.As<Napi::Object>();
+			Napi::Value own_keys = object_keys.Call({ object });
+			size_t member_count = 0;
+
+			if(own_keys.IsEmpty()){
+				throw std::invalid_argument("Failed reading object keys");
+			}
+
+			Napi::Array keys = own_keys.As<Napi::Array>();
+
+			if(!sink.StartObject()){
+				return false;
+			}
+
+			for(uint32_t i_key = 0; i_key < keys.Length(); i_key++){
+				std::string key = keys.Get(i_key).As<Napi::String>();
+				Napi::Value member = object.Get(key);
+
+				// skipped by JSON.stringify()
+				if(member.IsUndefined() || member.IsFunction()){
+					continue;
+				}
+
+				path.push_back(key);
+
+				if(!sink.Key(key.c_str(), key.size()) || !emit_value(sink, member)){
+					return false;
+				}
+
+				path.pop_back();
+				member_count++;
+			}
+
+			return sink.EndObject(member_count);
+		}
+
+		throw std::invalid_argument("Value type is not supported");
+	}
+};
+
+// returns false if value is neither JSON string, Buffer nor object
+bool js_to_config(const Napi::Value& value, jsConfig& config)
+{
+	if(value.IsString()){
+		config.text = value.As<Napi::String>();
+		config.json = config.text.c_str();
+		config.length = config.text.size();
+
+		return true;
+	}
+
+	if(value.IsBuffer()){
+		Napi::Buffer<char> buffer = value.As<Napi::Buffer<char>>();
+		config.json = buffer.Data();
+		config.length = buffer.Length();
+
+		return true;
+	}
+
+	if(value.IsObject() && !value.IsFunction()){
+		config.object = value;
+
+		return true;
+	}
+
+	return false;
+}
+
+int8_t parse_js_config(const jsConfig& config, std::vector<slaveEntry>& entries,
+	slave_size_et *entries_length, std::vector<startupConfig>& parameters,
+	sparam_size_et *parameters_length, std::vector<uint8_t>& parameter_data,
+	std::vector<std::string>& names, const char *schema, bool do_sort,
+	const esiCatalog *catalog)
+{
+	if(config.json != NULL){
+		return parse_json_buffer(config.json, config.length, entries, entries_length,
+			parameters, parameters_length, parameter_data, names, schema, do_sort,
+			catalog);
+	}
+
+	jsConfigSource source(config.object);
+
+	return parse_config_events(source, entries, entries_length, parameters,
+		parameters_length, parameter_data, names, schema, do_sort, catalog);
+}
+
+// Parse slave configuration, or load it from compiled configuration if
+// source is unchanged. JS object can't be hashed, so it's never cached.
+int8_t configure_slaves(const jsConfig& config)
+{
+	bool is_cached = !cache_path.empty() && config.json != NULL;
+	uint64_t source_hash = 0;
+
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+
+	int8_t loaded = -1;
+	int8_t parsing = 0;
+
+	// use compiled configuration if source is unchanged
+	if(is_cached){
+		source_hash = config_source_hash(config.json, config.length,
+			schema_json.empty() ? NULL : schema_json.c_str(), do_sort_slave,
+			esi_paths.empty() ? 0 : esi_files_stamp(esi_paths));
+
+		loaded = load_config_cache(
+				cache_path.c_str(),
+				source_hash,
+				entries,
+				&entries_length,
+				parameters,
+				&parameters_length,
+				parameter_data,
+				names
+			);
+
+#if DEBUG > 0
+		if(loaded == 0){
+			printf("Slave configuration is loaded from %s\n", cache_path.c_str());
+		}
+#endif
+	}
+
+	if(loaded != 0){
+		// ESI catalog is only needed if configuration has to be parsed
+		esiCatalog esi_catalog = {};
+		if(!esi_paths.empty()){
+			load_esi_catalog(esi_paths, esi_catalog);
+		}
+
+		parsing = parse_js_config(
+				config,
+				entries,
+				&entries_length,
+				parameters,
+				&parameters_length,
+				parameter_data,
+				names,
+				schema_json.empty() ? NULL : schema_json.c_str(),
+				do_sort_slave,
+				esi_paths.empty() ? NULL : &esi_catalog
+			);
+
+		if(is_cached && save_config_cache(cache_path.c_str(), source_hash,
+			entries, parameters, parameter_data, names) < 0
+		){
+			fprintf(stderr, "Failed writing slave configuration cache %s\n",
+				cache_path.c_str());
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(configured_mutex);
+
+	configured_entries.swap(entries);
+	configured_parameters.swap(parameters);
+	configured_parameter_data.swap(parameter_data);
+	configured_names.swap(names);
+	is_slave_configured = true;
+
+	return parsing;
+}
+
+// Copy configured slaves into the ones used by master
 int8_t init_slave()
 {
-	return parse_json(
-			&json_path[0],
-			slave_entries,
-			&slave_entries_length,
-			startup_parameters,
-			&startup_parameters_length,
-			do_sort_slave
-		);
+	std::lock_guard<std::mutex> lock(configured_mutex);
+
+	if(!is_slave_configured){
+		return -1;
+	}
+
+	int64_t started_ns = monotonic_ns();
+
+	slave_entries = configured_entries;
+	slave_entries_length = configured_entries.size();
+	startup_parameters = configured_parameters;
+	startup_parameters_length = configured_parameters.size();
+	startup_parameter_data = configured_parameter_data;
+	entry_names = configured_names;
+
+	end_startup_phase(PHASE_INIT_SLAVE, started_ns);
+
+	return 0;
 }
 
 void init_master_and_domain()
@@ -904,18 +1805,29 @@ void init_master_and_domain()
 		exit(EXIT_FAILURE);
 	}
 
+	int64_t started_ns = monotonic_ns();
+
 	/* configure Slaves at startup */
 	slave_startup_config(master);
+	end_startup_phase(PHASE_SLAVE_CONFIG, started_ns);
 
 	/* Configure PDO at startup */
+	started_ns = monotonic_ns();
 	syncmanager_startup_config();
+	end_startup_phase(PHASE_SYNCMANAGER_CONFIG, started_ns);
 
 	/* Startup parameters */
+	started_ns = monotonic_ns();
 	startup_parameters_config();
+	end_startup_phase(PHASE_PARAMETERS_CONFIG, started_ns);
 
 	/* Configuring Domain */
+	started_ns = monotonic_ns();
 	domain_startup_config(&DomainN_regs, &DomainN_length);
 	IOs_length = DomainN_length;
+	end_startup_phase(PHASE_DOMAIN_CONFIG, started_ns);
+
+	assign_entry_scaling();
 
 	// Create a new process data domain
 	if (!(DomainN = ecrt_master_create_domain(master))) {
@@ -926,6 +1838,7 @@ void init_master_and_domain()
 		exit(EXIT_FAILURE);
 	}
 
+	started_ns = monotonic_ns();
 	if (ecrt_domain_reg_pdo_entry_list(DomainN, DomainN_regs)) {
 		Napi::Error::Fatal(
 				"init_master_and_domain",
@@ -933,12 +1846,14 @@ void init_master_and_domain()
 			);
 		exit(EXIT_FAILURE);
 	}
+	end_startup_phase(PHASE_DOMAIN_REGISTRATION, started_ns);
 
 	// free allocated memories from startup configurations
 	free(DomainN_regs);
 
 	// map domain indexes
 	assign_domain_identifier();
+	assign_domain_names();
 
 #if DEBUG > 0
 	fprintf(stdout, "\nMaster & Domain have been initialized.\n");
@@ -957,6 +1872,9 @@ void activate_master()
 #if DEBUG > 0
 	fprintf(stdout, "\nActivating master...\n");
 #endif
+	startup_phases[PHASE_OPERATIONAL].store(STARTUP_PHASE_NONE, std::memory_order_relaxed);
+
+	int64_t started_ns = monotonic_ns();
 	if (ecrt_master_activate(master)) {
 		Napi::Error::Fatal(
 				"init_master_and_domain",
@@ -964,6 +1882,9 @@ void activate_master()
 			);
 		exit(EXIT_FAILURE);
 	}
+	end_startup_phase(PHASE_MASTER_ACTIVATION, started_ns);
+
+	master_activated_ns.store(monotonic_ns(), std::memory_order_relaxed);
 
 #if DEBUG > 0
 	fprintf(stdout, "\nInitializing Domain data...\n");
@@ -1026,106 +1947,418 @@ void write_sdo_data(ec_sdo_request_t* req, const ecat_size_al& size, void* value
 	}
 }
 
-int8_t sdo_request(const sdo_req_type_al& rtype, void* result, const ecat_pos_al& pos,
-	const ecat_index_al& s_index, const ecat_sub_al& s_subindex,
-	const ecat_size_al& size, const uint32_t& timeout, const uint8_t& verbosity)
+int8_t sdo_request_start(SdoJob *job)
 {
-	struct timespec start, current;
-
 	ec_slave_config_t* slave;
-	ec_slave_config_state_t* state;
-
-	// SDO Request
-	ec_sdo_request_t *sdo_req;
-
-	try {
-		slave = sc_slaves.at(pos);
-		state = &slaves.at(pos).state;
+	ec_slave_config_state_t slave_state = {};
+	ec_slave_config_state_t* state = &slave_state;
+
+	// lock is shared with cyclic task, so it's not held during ioctls. Slave
+	// config stays valid until SDO thread has left, see sdo_cancel_jobs()
+	{
+		std::lock_guard<std::mutex> lock(slaves_mutex);
+		int32_t slNumber = _slave_index(job->position);
+
+		if(slNumber == SLAVE_INDEX_NONE){
+			if(job->verbosity > 0){
+				fprintf(stderr, "Slave pos %d doesn't exist! (%d slaves)\n",
+					job->position, slaves_length);
+			}
 
-		ecrt_slave_config_state(slave, state);
-	} catch (const std::out_of_range& err) {
-		if(verbosity > 0){
-			fprintf(stderr, "Slave pos %d doesn't exist! (max %ld)\n",
-				pos, sc_slaves.size());
+			return 2;
 		}
 
-		return 2;
+		slave = sc_slaves[slNumber];
 	}
 
+	ecrt_slave_config_state(slave, state);
+
 #if DEBUG > 1
 	fprintf(stdout,
 		"%d Slave %d 0x%04x:%02x - Online %02x | OP %02x | State %02x\n",
-		rtype, pos, s_index, s_subindex, state->online, state->operational,
-		state->al_state);
+		job->rtype, job->position, job->index, job->subindex, state->online,
+		state->operational, state->al_state);
 #endif
 
 	// TODO: Find how Busy Request never ends once it happens.
 	// this condition is to prevent infinite Busy Request, but tbh I'm not sure why it happens.
 	// so for now, I simply prevent creating request when slave is in INIT state
 	if(state->al_state == 0x01){
-		if(verbosity > 0){
+		if(job->verbosity > 0){
 			fprintf(stderr, "Slave %d 0x%04x:%02x is in INIT state! (%02x)\n",
-				pos, s_index, s_subindex, state->al_state);
+				job->position, job->index, job->subindex, state->al_state);
 		}
 
 		return 3;
 	}
 
-	if (!(sdo_req = ecrt_slave_config_create_sdo_request(slave, s_index, s_subindex, size))) {
-		if(verbosity > 0){
+	job->req = ecrt_slave_config_create_sdo_request(slave, job->index,
+		job->subindex, job->size);
+
+	if (!job->req) {
+		if(job->verbosity > 0){
 			fprintf(stderr, "Failed to create SDO request!\n");
 		}
 
 		return 1;
 	}
 
-	if(rtype == ECAT_SDO_READ){
-		ecrt_sdo_request_read(sdo_req);
+	if(job->rtype == ECAT_SDO_READ){
+		ecrt_sdo_request_read(job->req);
 	} else {
 		// data should be set before requesting sdo
-		write_sdo_data(sdo_req, size, result);
-		ecrt_sdo_request_write(sdo_req);
+		write_sdo_data(job->req, job->size, &job->data);
+		ecrt_sdo_request_write(job->req);
 	}
 
-	ecrt_sdo_request_timeout(sdo_req, timeout);
+	ecrt_sdo_request_timeout(job->req, job->timeout);
 
-	clock_gettime(CLOCK_MONOTONIC, &start);
+	clock_gettime(CLOCK_MONOTONIC, &job->started);
 
-	while(1){
-		switch (ecrt_sdo_request_state(sdo_req)) {
-			case EC_REQUEST_UNUSED:
-				if(verbosity > 0){
-					fprintf(stderr, "Unused request!\n");
-				}
-				// request was not used yet, trigger read
-				ecrt_sdo_request_read(sdo_req);
-				break;
+	return 0;
+}
 
-			case EC_REQUEST_BUSY:
-				// there's possibility the loop stuck in busy state
-				// limit the loop with the timeout
-				clock_gettime(CLOCK_MONOTONIC, &current);
-				if((NSEC_PER_SEC * (current.tv_sec - start.tv_sec))
-					+ current.tv_nsec - start.tv_nsec > (timeout * 1000000)){
+int8_t sdo_request_poll(SdoJob *job)
+{
+	struct timespec current;
 
-					if(verbosity > 0){
-						fprintf(stderr, "Timeout waiting for Busy Request!\n");
-					}
+	switch (ecrt_sdo_request_state(job->req)) {
+		case EC_REQUEST_UNUSED:
+			if(job->verbosity > 0){
+				fprintf(stderr, "Unused request!\n");
+			}
+			// request was not used yet, trigger read
+			ecrt_sdo_request_read(job->req);
+			return 1;
 
-					return 4;
+		case EC_REQUEST_BUSY:
+			// there's possibility the request stuck in busy state
+			// limit the request with the timeout
+			clock_gettime(CLOCK_MONOTONIC, &current);
+			if((NSEC_PER_SEC * (current.tv_sec - job->started.tv_sec))
+				+ current.tv_nsec - job->started.tv_nsec
+				> (job->timeout * 1000000)){
+
+				if(job->verbosity > 0){
+					fprintf(stderr, "Timeout waiting for Busy Request!\n");
 				}
-				break;
 
-			case EC_REQUEST_SUCCESS: {
-				read_sdo_data(sdo_req, size, result);
-				return 0;
-			} break;
+				return 4;
+			}
+			return 1;
+
+		case EC_REQUEST_SUCCESS:
+			read_sdo_data(job->req, job->size, &job->data);
+			return 0;
+
+		case EC_REQUEST_ERROR:
+		default:
+			return -1;
+	}
+}
+
+const char* sdo_status_message(int8_t status)
+{
+	switch(status){
+		case 1: return "Failed to create SDO request";
+		case 2: return "Slave doesn't exist";
+		case 3: return "Slave is in INIT state";
+		case 4: return "Timeout waiting for SDO request";
+		case 5: return "SDO request cancelled, master is released";
+		case 6: return "Master is not initialized";
+		default: return "SDO request failed";
+	}
+}
+
+// Make parameters of reconfigure() the configured ones, used by the next
+// initialization. Runs on the JS thread.
+void commit_pending_parameters()
+{
+	std::lock_guard<std::mutex> lock(configured_mutex);
+
+	configured_parameters.swap(pending_parameters.parameters);
+	configured_parameter_data.swap(pending_parameters.parameter_data);
+}
+
+// Count settled SDO write of reconfigure(), parameters are committed once
+// the last one is settled and all of them succeeded
+void settle_pending_parameter(bool is_failed)
+{
+	pending_parameters.is_failed = pending_parameters.is_failed || is_failed;
+
+	if(--pending_parameters.writes > 0){
+		return;
+	}
+
+	if(!pending_parameters.is_failed){
+		commit_pending_parameters();
+	}
+
+	pending_parameters.is_pending = false;
+	pending_parameters.parameters.clear();
+	pending_parameters.parameter_data.clear();
+}
+
+// Resolve or reject the Promise of a finished SDO job. Runs on the JS thread.
+void sdo_job_settle(Napi::Env env, Napi::Function jsCallback, SdoJob *job)
+{
+	if(job->is_reconfigure){
+		settle_pending_parameter(job->status != 0);
+	}
+
+	if(job->status == 0){
+		switch(job->size){
+			case 1: job->deferred.Resolve(Napi::Number::New(env, job->data.byte)); break;
+			case 2: job->deferred.Resolve(Napi::Number::New(env, job->data.word)); break;
+			default: job->deferred.Resolve(Napi::Number::New(env, job->data.dword)); break;
+		}
+	} else {
+		Napi::Error error = Napi::Error::New(env, sdo_status_message(job->status));
+		error.Set("code", Napi::Number::New(env, job->status));
+		error.Set("position", Napi::Number::New(env, job->position));
+		error.Set("index", Napi::Number::New(env, job->index));
+		error.Set("subindex", Napi::Number::New(env, job->subindex));
+
+		job->deferred.Reject(error.Value());
+	}
+
+	delete job;
+}
+
+void sdo_finalizer_callback(Napi::Env env, void *finalizeData, SdoContext *context)
+{
+	context->nativeThread.join();
+	delete context;
+}
+
+// SDO thread entry point. Keeps progressing every in-flight request until both
+// the queue and the in-flight list are empty, then leaves.
+void sdo_thread_entry(SdoContext *context)
+{
+	std::vector<SdoJob*> in_flight;
+	std::vector<SdoJob*> starting;
+
+	while(1){
+		bool is_cancelling;
+
+		{
+			std::lock_guard<std::mutex> lock(sdo_mutex);
+
+			// jobs are only taken here, they are started after unlocking
+			starting.assign(sdo_queue.begin(), sdo_queue.end());
+			sdo_queue.clear();
+
+			is_cancelling = sdo_cancelling;
+
+			// requests are freed with their slave configs, they are not
+			// polled anymore once master is being released
+			if(is_cancelling){
+				for(SdoJob *job : in_flight){
+					if(job->status == 0){
+						job->status = 5;
+					}
+				}
+			}
+
+			if(in_flight.empty() && starting.empty()){
+				sdo_thread_running = false;
+				sdo_idle.notify_all();
+				break;
+			}
+		}
+
+		for(SdoJob *job : starting){
+			job->status = is_cancelling ? 5 : sdo_request_start(job);
+			in_flight.push_back(job);
+		}
+
+		for(size_t i_job = 0; i_job < in_flight.size();){
+			SdoJob *job = in_flight[i_job];
+
+			// status is still 0 after a successful start, poll until done
+			if(job->req && job->status == 0){
+				job->status = sdo_request_poll(job);
+
+				// still busy, check next job
+				if(job->status == 1){
+					i_job++;
+					continue;
+				}
+			}
+
+			if(context->tsfn.NonBlockingCall(job, sdo_job_settle) != napi_ok){
+				fprintf(stderr, "Failed to settle SDO request 0x%04x:%02x\n",
+					job->index, job->subindex);
+			}
+
+			in_flight[i_job] = in_flight.back();
+			in_flight.pop_back();
+		}
+
+		std::this_thread::sleep_for(std::chrono::nanoseconds(SDO_POLL_PERIOD_NS));
+	}
+
+	context->tsfn.Release();
+}
+
+// Queue SDO job and make sure the SDO thread is running. Must be called from JS thread.
+Napi::Promise sdo_job_enqueue(Napi::Env env, SdoJob *job)
+{
+	Napi::Promise promise = job->deferred.Promise();
+
+	std::lock_guard<std::mutex> lock(sdo_mutex);
+
+	// master is not initialized or is being released
+	if(isMasterReady != 1 || sdo_cancelling){
+		job->status = sdo_cancelling ? 5 : 6;
+		sdo_job_settle(env, Napi::Function(), job);
+
+		return promise;
+	}
+
+	sdo_queue.push_back(job);
+
+	if(!sdo_thread_running){
+		auto _ctx = new SdoContext();
+
+		_ctx->tsfn = Napi::ThreadSafeFunction::New(
+				env, // Environment
+				Napi::Function::New(env, [](const Napi::CallbackInfo&){}),
+				"SDO", // Resource name
+				0, // Max queue size (0 = unlimited).
+				1, // Initial thread count
+				_ctx, // Context,
+				sdo_finalizer_callback, // Finalizer
+				(void *)nullptr	// Finalizer data
+			);
+
+		sdo_thread_running = true;
+		_ctx->nativeThread = std::thread(sdo_thread_entry, _ctx);
+	}
+
+	return promise;
+}
+
+// Reject queued and in-flight SDO jobs and wait until SDO thread leaves.
+// Must be called before slave configs are freed, i.e. before master is
+// deactivated or released.
+void sdo_cancel_jobs()
+{
+	std::unique_lock<std::mutex> lock(sdo_mutex);
+
+	sdo_cancelling = true;
+	sdo_idle.wait(lock, []{ return !sdo_thread_running; });
+	sdo_cancelling = false;
+}
+
+/****************************************************************************/
+
+void cycle_queue_init()
+{
+	std::lock_guard<std::mutex> lock(cycle_queue.mutex);
+
+	cycle_queue.policy = cycle_queue_policy;
+	cycle_queue.capacity = cycle_queue.policy == QUEUE_COALESCE
+							? 1
+							: cycle_queue_capacity;
+
+	// preallocate every slot, so cyclic task never allocates memory
+	cycle_queue.slots.resize(cycle_queue.capacity);
+	for(size_t i_slot = 0; i_slot < cycle_queue.capacity; i_slot++){
+		cycle_queue.slots[i_slot].values.resize(IOs_length);
+		cycle_queue.slots[i_slot].scaled.resize(IOs_is_scaled ? IOs_length : 0);
+	}
+	js_snapshot.values.resize(IOs_length);
+	js_snapshot.scaled.resize(IOs_is_scaled ? IOs_length : 0);
+
+	cycle_queue.head = 0;
+	cycle_queue.count = 0;
+	cycle_queue.notify_pending = false;
 
-			case EC_REQUEST_ERROR:{
-				return -1;
-			} break;
+	cycle_queue.delivered = 0;
+	cycle_queue.dropped = 0;
+	cycle_queue.coalesced = 0;
+}
+
+// Copy current domain values into the queue according to queue policy.
+// Returns false if current cycle is not queued.
+bool cycle_queue_push(int64_t timestamp_ns)
+{
+	std::unique_lock<std::mutex> lock(cycle_queue.mutex);
+
+	if(cycle_queue.count == cycle_queue.capacity){
+		switch(cycle_queue.policy){
+			case QUEUE_BLOCK:
+				// opt-in only, frames aren't sent or received while waiting.
+				// Keep checking running state, so cyclic task can be stopped
+				while(cycle_queue.count == cycle_queue.capacity && _running_state == 1){
+					cycle_queue.not_full.wait_for(lock, std::chrono::milliseconds(100));
+				}
+
+				if(cycle_queue.count == cycle_queue.capacity){
+					return false;
+				}
+				break;
+
+			case QUEUE_DROP_NEWEST:
+				cycle_queue.dropped++;
+				return false;
+
+			case QUEUE_DROP_OLDEST:
+				cycle_queue.head = (cycle_queue.head + 1) % cycle_queue.capacity;
+				cycle_queue.count--;
+				cycle_queue.dropped++;
+				break;
+
+			case QUEUE_COALESCE:
+				cycle_queue.head = (cycle_queue.head + 1) % cycle_queue.capacity;
+				cycle_queue.count--;
+				cycle_queue.coalesced++;
+				break;
+		}
+	}
+
+	cycleSnapshot& slot = cycle_queue.slots[
+			(cycle_queue.head + cycle_queue.count) % cycle_queue.capacity
+		];
+
+	for(io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
+		slot.values[dmn_idx] = IOs[dmn_idx].value;
+	}
+
+	if(IOs_is_scaled){
+		std::copy(IOs_scaled.begin(), IOs_scaled.end(), slot.scaled.begin());
+	}
+
+	slot.al_states = master_state.al_states;
+	slot.timestamp_ns = timestamp_ns;
+
+	cycle_queue.count++;
+
+	return true;
+}
+
+// Move oldest snapshot into js_snapshot. Returns false if queue is empty.
+bool cycle_queue_pop()
+{
+	{
+		std::lock_guard<std::mutex> lock(cycle_queue.mutex);
+
+		if(cycle_queue.count == 0){
+			return false;
 		}
+
+		// swap instead of copy, both vectors have the same preallocated size
+		std::swap(js_snapshot, cycle_queue.slots[cycle_queue.head]);
+
+		cycle_queue.head = (cycle_queue.head + 1) % cycle_queue.capacity;
+		cycle_queue.count--;
+		cycle_queue.delivered++;
 	}
+
+	cycle_queue.not_full.notify_one();
+
+	return true;
 }
 
 /****************************************************************************/
@@ -1143,28 +2376,88 @@ void finalizer_callback(Napi::Env env, void *finalizeData, TsfnContext *context)
 	delete context;
 }
 
-// The thread entry point. This takes as its arguments the specific
-// threadsafe-function context created inside the main thread.
-void thread_entry(TsfnContext *context) {
-	auto callback = [](Napi::Env env, Napi::Function jsCallback, int8_t* data) {
-		Napi::Array values = Napi::Array::New(env, IOs_length);
+// Deliver cycle snapshot to JS callback. Runs on the JS thread.
+void deliver_cycle(Napi::Env env, Napi::Function jsCallback)
+{
+	Napi::Array values = Napi::Array::New(env, IOs_length);
+
+	for(io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
+		Napi::Object indexValue = Napi::Object::New(env);
+		indexValue.Set("position", Napi::Value::From(env, IOs[dmn_idx].position));
+		indexValue.Set("index", Napi::Value::From(env, IOs[dmn_idx].index));
+		indexValue.Set("subindex", Napi::Value::From(env, IOs[dmn_idx].subindex));
+		indexValue.Set("value",
+			entry_value_to_js(env, IOs[dmn_idx], js_snapshot.values[dmn_idx]));
+
+		values[dmn_idx] = indexValue;
+	}
+
+	int64_t now = monotonic_ns();
+	int64_t interval = 0;
+	bool is_operational = MASTER_STATE_DETAIL(AL_BIT_OP, js_snapshot.al_states);
 
-		for(io_size_et dmn_idx = 0; dmn_idx < IOs_length; dmn_idx++){
-			Napi::Object indexValue = Napi::Object::New(env);
-			indexValue.Set("position", Napi::Value::From(env, IOs[dmn_idx].position));
-			indexValue.Set("index", Napi::Value::From(env, IOs[dmn_idx].index));
-			indexValue.Set("subindex", Napi::Value::From(env, IOs[dmn_idx].subindex));
-			indexValue.Set("value", Napi::Value::From(env, IOs[dmn_idx].value));
+	// only sample timing while master is in OP state. Intervals are taken
+	// from cycle timestamps, queued cycles are delivered back to back.
+	if(!is_operational){
+		cycle_timing.last_timestamp_ns = 0;
+		cycle_timing.last_interval_ns = 0;
+	} else if(cycle_timing.last_timestamp_ns == 0){
+		cycle_timing.last_timestamp_ns = js_snapshot.timestamp_ns;
+	} else {
+		interval = js_snapshot.timestamp_ns - cycle_timing.last_timestamp_ns;
+		cycle_timing.last_timestamp_ns = js_snapshot.timestamp_ns;
 
-			values[dmn_idx] = indexValue;
+		if(cycle_timing.last_interval_ns){
+			cycle_timing.jitter.add(std::abs(interval - cycle_timing.last_interval_ns));
 		}
 
-		jsCallback.Call({
-				values,
-				Napi::Number::New(env, master_state.al_states)
-			});
-	};
+		cycle_timing.last_interval_ns = interval;
+		cycle_timing.latency.add(interval);
+		cycle_timing.delivery.add(now - js_snapshot.timestamp_ns);
+	}
+
+	// engineering values, only if any entry is scaled
+	Napi::Value scaled = env.Undefined();
+	if(IOs_is_scaled){
+		Napi::Float64Array scaled_values = Napi::Float64Array::New(env, IOs_length);
+		std::copy(js_snapshot.scaled.begin(), js_snapshot.scaled.end(),
+			scaled_values.Data());
+
+		scaled = scaled_values;
+	}
+
+	jsCallback.Call({
+			values,
+			Napi::Number::New(env, js_snapshot.al_states),
+			Napi::Number::New(env, now),
+			Napi::Number::New(env, interval),
+			scaled
+		});
+
+	if(is_operational && interval){
+		cycle_timing.processing.add(monotonic_ns() - now);
+	}
+}
+
+// Deliver every queued cycle, new drain call may be queued from now on.
+// env is null if thread-safe function is being finalized.
+void drain_cycles(Napi::Env env, Napi::Function jsCallback, TsfnContext *context,
+	void *data)
+{
+	cycle_queue.notify_pending = false;
+
+	if(env == nullptr){
+		return;
+	}
+
+	while(cycle_queue_pop()){
+		deliver_cycle(env, jsCallback);
+	}
+}
 
+// The thread entry point. This takes as its arguments the specific
+// threadsafe-function context created inside the main thread.
+void thread_entry(TsfnContext *context) {
 	struct timespec wakeup_time;
 	int8_t ret = 0;
 
@@ -1173,8 +2466,12 @@ void thread_entry(TsfnContext *context) {
 	fprintf(stdout, "%ld.%09ld | Program Started\n", epoch.tv_sec, epoch.tv_nsec);
 #endif
 
+	// re-initialized after stop from configured slaves, without parsing
 	if(isMasterReady != 1){
+		is_reinitializing = true;
+		reset_startup_phases();
 		init_master_and_domain();
+		is_reinitializing = false;
 	}
 
 	// activate master and initialize domain data
@@ -1195,6 +2492,9 @@ void thread_entry(TsfnContext *context) {
 	fprintf(stdout, "\nStarting RT task with dt=%u ns.\n", PERIOD_NS);
 #endif
 
+	reset_cycle_timing();
+	cycle_queue_init();
+
 	clock_gettime(CLOCK_MONOTONIC, &wakeup_time);
 	wakeup_time.tv_sec += 1; /* start in future */
 	wakeup_time.tv_nsec = 0;
@@ -1213,18 +2513,30 @@ void thread_entry(TsfnContext *context) {
 
 		cyclic_task(master, DomainN_length);
 
-		napi_status status = context->tsfn.BlockingCall(&ret, callback);
+		if(cycle_queue_push(monotonic_ns()) && !cycle_queue.notify_pending.exchange(true)){
+			napi_status status = context->tsfn.NonBlockingCall();
 
-		if (status != napi_ok) {
-			Napi::Error::Fatal(
-					"thread_entry",
-					"Napi::ThreadSafeNapi::Function.BlockingCall() failed"
-				);
+			// owning environment is shutting down, stop cyclic task
+			if (status == napi_closing) {
+				_running_state = 0;
+				break;
+			}
+
+			// full TSFN queue means a drain call is still pending
+			if (status != napi_ok && status != napi_queue_full) {
+				Napi::Error::Fatal(
+						"thread_entry",
+						"Napi::ThreadSafeNapi::Function.NonBlockingCall() failed"
+					);
+			}
 		}
 
 		set_next_wait_period(&wakeup_time);
 	}
 
+	// slave configs and their SDO requests are freed by deactivation
+	sdo_cancel_jobs();
+
 	ecrt_master_deactivate(master);
 
 	// wait until OP bit is reset after deactivation
@@ -1240,137 +2552,1072 @@ void thread_entry(TsfnContext *context) {
 	ecrt_release_master(master);
 	isMasterReady = 0;
 
-	context->tsfn.Release();
+	{
+		std::lock_guard<std::mutex> lock(master_owner_mutex);
+
+		if(master_owner == MASTER_OWNER_ORPHANED){
+			master_owner = MASTER_OWNER_NONE;
+		}
+	}
+
+	context->tsfn.Release();
+}
+
+/****************************************************************************
+ * Node API
+ ****************************************************************************/
+
+// Claim EtherCAT master for the calling environment, if it's not owned yet.
+// Throws JS exception and returns false if other environment owns it.
+bool claim_master(Napi::Env env)
+{
+	if(master_owner.load(std::memory_order_acquire) == env_id){
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(master_owner_mutex);
+
+	if(master_owner == MASTER_OWNER_NONE){
+		master_owner.store(env_id, std::memory_order_release);
+	}
+
+	if(master_owner != env_id){
+		Napi::Error::New(env, MASTER_OWNER_ERROR).ThrowAsJavaScriptException();
+
+		return false;
+	}
+
+	return true;
+}
+
+// Reads don't claim master, so an unowned master is still free to be claimed
+// by init() of other environment, e.g. a worker.
+inline static bool is_master_readable()
+{
+	uint32_t owner = master_owner.load(std::memory_order_acquire);
+
+	return owner == env_id || owner == MASTER_OWNER_NONE;
+}
+
+// Throws JS exception and returns false if other environment owns master.
+bool check_master_owner(Napi::Env env)
+{
+	if(is_master_readable()){
+		return true;
+	}
+
+	Napi::Error::New(env, MASTER_OWNER_ERROR).ThrowAsJavaScriptException();
+
+	return false;
+}
+
+// Release master ownership when the owning environment is torn down,
+// i.e. its worker exits. Running cyclic task is stopped and will give up
+// the ownership once the master is released.
+void addon_data_finalize(Napi::Env env, AddonData *data)
+{
+	std::lock_guard<std::mutex> lock(master_owner_mutex);
+
+	if(master_owner == data->id){
+		if(_running_state == 1){
+			_running_state = 0;
+			master_owner = MASTER_OWNER_ORPHANED;
+		} else {
+			if(isMasterReady == 1){
+				sdo_cancel_jobs();
+				reset_global_vars();
+				ecrt_release_master(master);
+				isMasterReady = 0;
+			}
+
+			master_owner = MASTER_OWNER_NONE;
+		}
+	}
+
+	delete data;
+}
+
+// Strings of JS array, non string elements are ignored
+std::vector<std::string> js_to_strings(const Napi::Value& value)
+{
+	std::vector<std::string> strings;
+
+	if(!value.IsArray()){
+		return strings;
+	}
+
+	Napi::Array array = value.As<Napi::Array>();
+
+	for(uint32_t i_item = 0; i_item < array.Length(); i_item++){
+		Napi::Value item = array.Get(i_item);
+
+		if(item.IsString()){
+			strings.push_back(item.As<Napi::String>());
+		}
+	}
+
+	return strings;
+}
+
+Napi::Value js_init_slave(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	do_sort_slave = 0;
+
+	jsConfig config;
+	if (info.Length() < 1 || !js_to_config(info[0], config)){
+		Napi::TypeError::New(
+				env,
+				"Expected 1 Parameter(s) to be passed [ String | Buffer | Object ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	if (slave_entries_length > 0){
+		Napi::TypeError::New(
+				env,
+				"Slaves are already initialized!"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	if (info.Length() >= 2){
+		do_sort_slave = info[1].As<Napi::Boolean>() ? true : false;
+	}
+
+	// optional JSON schema to validate slave configuration against
+	schema_json.clear();
+	if (info.Length() >= 3 && info[2].IsString()){
+		schema_json = info[2].As<Napi::String>();
+	}
+
+	// optional path of compiled configuration
+	cache_path.clear();
+	if (info.Length() >= 4 && info[3].IsString()){
+		cache_path = info[3].As<Napi::String>();
+	}
+
+	// optional ESI files to resolve slaves defined by identity only
+	esi_paths.clear();
+	if (info.Length() >= 5){
+		esi_paths = js_to_strings(info[4]);
+	}
+
+	int8_t parsing;
+
+	// report covers phases of this initialization only
+	reset_startup_phases();
+	int64_t started_ns = monotonic_ns();
+
+	try {
+		parsing = configure_slaves(config);
+	} catch (const std::exception& err) {
+		Napi::Error::New(env, err.what()).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	end_startup_phase(PHASE_CONFIGURE_SLAVES, started_ns);
+
+	init_master_and_domain();
+
+	return Napi::Number::New(env, parsing);
+}
+
+Napi::Value js_compile_config(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// compiled configuration is keyed by hash of source text
+	jsConfig source;
+	if (info.Length() < 2 || (!info[0].IsString() && !info[0].IsBuffer())
+		|| !js_to_config(info[0], source) || !info[1].IsString()
+	){
+		Napi::TypeError::New(
+				env,
+				"Expected 2 Parameter(s) to be passed [ String | Buffer, String ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	std::string output = info[1].As<Napi::String>();
+	bool do_sort = info.Length() >= 3 && info[2].IsBoolean()
+					&& info[2].As<Napi::Boolean>();
+
+	std::string schema;
+	if (info.Length() >= 4 && info[3].IsString()){
+		schema = info[3].As<Napi::String>();
+	}
+
+	std::vector<std::string> esi_files;
+	if (info.Length() >= 5){
+		esi_files = js_to_strings(info[4]);
+	}
+
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+	esiCatalog esi_catalog = {};
+
+	try {
+		if(!esi_files.empty()){
+			load_esi_catalog(esi_files, esi_catalog);
+		}
+
+		parse_json_buffer(
+				source.json,
+				source.length,
+				entries,
+				&entries_length,
+				parameters,
+				&parameters_length,
+				parameter_data,
+				names,
+				schema.empty() ? NULL : schema.c_str(),
+				do_sort,
+				esi_files.empty() ? NULL : &esi_catalog
+			);
+	} catch (const std::exception& err) {
+		Napi::Error::New(env, err.what()).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	uint64_t source_hash = config_source_hash(source.json, source.length,
+		schema.empty() ? NULL : schema.c_str(), do_sort,
+		esi_files.empty() ? 0 : esi_catalog.stamp);
+
+	if(save_config_cache(output.c_str(), source_hash, entries, parameters,
+		parameter_data, names) < 0
+	){
+		Napi::Error::New(
+				env,
+				"Failed writing slave configuration cache " + output
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	return Napi::Number::New(env, entries_length);
+}
+
+Napi::Value js_scan_bus(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	bool do_load = info.Length() >= 1 && info[0].IsBoolean()
+					&& info[0].As<Napi::Boolean>();
+
+	if (do_load && slave_entries_length > 0){
+		Napi::TypeError::New(
+				env,
+				"Slaves are already initialized!"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	// master is only requested for the scan if it's not initialized yet
+	bool is_own_master = isMasterReady != 1;
+	ec_master_t *scan_master = is_own_master ? ecrt_request_master(0) : master;
+
+	if (!scan_master){
+		Napi::Error::New(
+				env,
+				"Failed at requesting master!"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	std::string config;
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length;
+
+	try {
+		scan_bus(scan_master, config, entries, &entries_length);
+	} catch (const std::exception& err) {
+		if(is_own_master){
+			ecrt_release_master(scan_master);
+		}
+
+		Napi::Error::New(env, err.what()).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	if(is_own_master){
+		ecrt_release_master(scan_master);
+	}
+
+	// scanned entries are used as they are, without parsing the generated JSON
+	if(do_load){
+		do_sort_slave = false;
+
+		{
+			std::lock_guard<std::mutex> lock(configured_mutex);
+
+			configured_entries.swap(entries);
+			configured_parameters.clear();
+			configured_parameter_data.clear();
+			configured_names.clear();
+			is_slave_configured = true;
+		}
+
+		reset_startup_phases();
+		init_slave();
+		init_master_and_domain();
+	}
+
+	return Napi::String::New(env, config);
+}
+
+Napi::Value js_reconfigure(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	jsConfig source;
+	if (info.Length() < 1 || !js_to_config(info[0], source)){
+		Napi::TypeError::New(
+				env,
+				"Expected 1 Parameter(s) to be passed [ String | Buffer | Object ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	if (slave_entries_length == 0){
+		Napi::TypeError::New(
+				env,
+				"Slaves are not initialized!"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	// configured parameters are compared and replaced, they must not change
+	// meanwhile
+	if (is_reinitializing || pending_parameters.is_pending){
+		Napi::Error::New(
+				env,
+				is_reinitializing
+					? "Master is being re-initialized!"
+					: "Previous reconfiguration is still being applied!"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	std::string schema;
+	if (info.Length() >= 2 && info[1].IsString()){
+		schema = info[1].As<Napi::String>();
+	}
+
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+	esiCatalog esi_catalog = {};
+
+	// parsed with the same options as running configuration
+	try {
+		if(!esi_paths.empty()){
+			load_esi_catalog(esi_paths, esi_catalog);
+		}
+
+		parse_js_config(
+				source,
+				entries,
+				&entries_length,
+				parameters,
+				&parameters_length,
+				parameter_data,
+				names,
+				schema.empty() ? NULL : schema.c_str(),
+				do_sort_slave,
+				esi_paths.empty() ? NULL : &esi_catalog
+			);
+	} catch (const std::exception& err) {
+		Napi::Error::New(env, err.what()).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	// configured slaves are the running ones with already applied parameters
+	std::vector<slaveChange> changes;
+	std::vector<size_t> changed_parameters;
+	bool is_hot_applicable = diff_config(
+			{
+				&configured_entries,
+				&configured_parameters,
+				&configured_parameter_data,
+				&configured_names
+			},
+			{ &entries, &parameters, &parameter_data, &names },
+			changes,
+			&changed_parameters
+		);
+
+	Napi::Array js_changes = Napi::Array::New(env, changes.size());
+	for(size_t i_change = 0; i_change < changes.size(); i_change++){
+		Napi::Object js_change = Napi::Object::New(env);
+		js_change.Set("position", Napi::Number::New(env, changes[i_change].position));
+		js_change.Set("change", Napi::String::New(env,
+			slave_change_name(changes[i_change].change)));
+
+		js_changes[i_change] = js_change;
+	}
+
+	// SDO job writes values up to 32 bits, others are set at startup only
+	for(size_t i_param = 0; is_hot_applicable && i_param < changed_parameters.size(); i_param++){
+		const startupConfig& parameter = parameters[changed_parameters[i_param]];
+
+		if(parameter.data_offset != PARAM_DATA_NONE || parameter.size > 32
+			|| parameter.complete_access
+		){
+			is_hot_applicable = false;
+		}
+	}
+
+	Napi::Array writes = Napi::Array::New(env);
+
+	// changed parameters are written by SDO, running layout is kept as it is.
+	// Updated parameters are used by the next initialization once all writes
+	// succeeded.
+	if(is_hot_applicable){
+		pending_parameters.is_pending = true;
+		pending_parameters.is_failed = false;
+		pending_parameters.writes = changed_parameters.size();
+		pending_parameters.parameters.swap(parameters);
+		pending_parameters.parameter_data.swap(parameter_data);
+
+		if(changed_parameters.empty()){
+			pending_parameters.writes = 1;
+			settle_pending_parameter(false);
+		}
+
+		for(size_t i_param : changed_parameters){
+			const startupConfig& parameter = pending_parameters.parameters[i_param];
+			SdoJob *job = new SdoJob(env);
+
+			job->rtype = ECAT_SDO_WRITE;
+			job->data.dword = parameter.value;
+			job->position = parameter.slavePosition;
+			job->index = parameter.index;
+			job->subindex = parameter.subindex;
+			job->size = parameter.size == 8 ? 1 : parameter.size == 16 ? 2 : 4;
+			job->is_reconfigure = true;
+
+			writes[writes.Length()] = sdo_job_enqueue(env, job);
+		}
+	}
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("restartRequired", Napi::Boolean::New(env, !is_hot_applicable));
+	result.Set("changes", js_changes);
+	result.Set("writes", writes);
+
+	return result;
+}
+
+Napi::Value js_plan_capacity(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	// planned offline, master is not requested
+	jsConfig source;
+	if (info.Length() < 1 || !js_to_config(info[0], source)){
+		Napi::TypeError::New(
+				env,
+				"Expected 1 Parameter(s) to be passed [ String | Buffer | Object ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	capacityOptions options = {
+			CAPACITY_LINK_SPEED,
+			CAPACITY_SLAVE_DELAY_NS,
+			PERIOD_NS
+		};
+
+	if (info.Length() >= 2 && info[1].IsNumber()){
+		options.period_ns = info[1].As<Napi::Number>().Uint32Value();
+	}
+
+	int64_t link_speed = (int64_t) CAPACITY_LINK_SPEED;
+	if (info.Length() >= 3 && info[2].IsNumber()){
+		link_speed = info[2].As<Napi::Number>().Int64Value();
+	}
+
+	if (info.Length() >= 4 && info[3].IsNumber()){
+		options.slave_delay_ns = info[3].As<Napi::Number>().Uint32Value();
+	}
+
+	if (link_speed <= 0){
+		Napi::RangeError::New(
+				env,
+				"Link speed must be greater than 0"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	options.link_speed = (uint64_t) link_speed;
+
+	std::string schema;
+	if (info.Length() >= 5 && info[4].IsString()){
+		schema = info[4].As<Napi::String>();
+	}
+
+	std::vector<std::string> esi_files;
+	if (info.Length() >= 6){
+		esi_files = js_to_strings(info[5]);
+	}
+
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+	esiCatalog esi_catalog = {};
+
+	// slave order doesn't change bus load
+	try {
+		if(!esi_files.empty()){
+			load_esi_catalog(esi_files, esi_catalog);
+		}
+
+		parse_js_config(
+				source,
+				entries,
+				&entries_length,
+				parameters,
+				&parameters_length,
+				parameter_data,
+				names,
+				schema.empty() ? NULL : schema.c_str(),
+				false,
+				esi_files.empty() ? NULL : &esi_catalog
+			);
+	} catch (const std::exception& err) {
+		Napi::Error::New(env, err.what()).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	capacityReport report;
+	plan_capacity(entries, options, report);
+
+	Napi::Array slaves = Napi::Array::New(env, report.slaves.size());
+	for(size_t i_slave = 0; i_slave < report.slaves.size(); i_slave++){
+		const slaveLoad& load = report.slaves[i_slave];
+
+		Napi::Object slave = Napi::Object::New(env);
+		slave.Set("position", Napi::Number::New(env, load.position));
+		slave.Set("inputBytes", Napi::Number::New(env, load.input_bytes));
+		slave.Set("outputBytes", Napi::Number::New(env, load.output_bytes));
+		slave.Set("wireTimeNs", Napi::Number::New(env, load.wire_time_ns));
+
+		slaves[i_slave] = slave;
+	}
+
+	Napi::Object result = Napi::Object::New(env);
+	result.Set("domainSize", Napi::Number::New(env, report.domain_size));
+	result.Set("inputBytes", Napi::Number::New(env, report.input_bytes));
+	result.Set("outputBytes", Napi::Number::New(env, report.output_bytes));
+	result.Set("datagrams", Napi::Number::New(env, report.datagrams));
+	result.Set("frames", Napi::Number::New(env, report.frames));
+	result.Set("wireBytes", Napi::Number::New(env, report.wire_bytes));
+	result.Set("wireTimeNs", Napi::Number::New(env, report.wire_time_ns));
+	result.Set("busTimeNs", Napi::Number::New(env, report.bus_time_ns));
+	result.Set("minPeriodNs", Napi::Number::New(env, report.min_period_ns));
+	result.Set("periodNs", Napi::Number::New(env, options.period_ns));
+	result.Set("load", Napi::Number::New(env, report.load));
+	result.Set("fits", Napi::Boolean::New(env, report.min_period_ns <= options.period_ns));
+	result.Set("slaves", slaves);
+
+	return result;
+}
+
+Napi::Value js_create_thread(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	// Construct context data
+	auto _ctx = new TsfnContext(env);
+
+	// Create a new ThreadSafeFunction.
+	_ctx->tsfn = Napi::TypedThreadSafeFunction<TsfnContext, void, drain_cycles>::New(
+			env, // Environment
+			info[0].As<Napi::Function>(), // JS function from caller
+			"TSFN", // Resource name
+			2, // Max queue size, cycles are queued in cycle_queue
+			2, // Initial thread count
+			_ctx, // Context,
+			finalizer_callback, // Finalizer
+			(void *)nullptr	// Finalizer data
+		);
+
+	_ctx->nativeThread = std::thread(thread_entry, _ctx);
+
+	return _ctx->deferred.Promise();
+}
+
+Napi::Value js_set_frequency(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	uint32_t frequency = info[0].As<Napi::Number>();
+
+	FREQUENCY = frequency;
+	PERIOD_NS = NSEC_PER_SEC / FREQUENCY;
+
+	return Napi::Number::New(env, PERIOD_NS);
+}
+
+Napi::Value set_period_us(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	uint32_t period_us = info[0].As<Napi::Number>();
+
+	PERIOD_NS = period_us * 1000;
+	FREQUENCY = NSEC_PER_SEC / (float(period_us) * 1000);
+
+	return Napi::Number::New(env, PERIOD_NS);
+}
+
+Napi::Value js_set_queue_policy(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()){
+		Napi::TypeError::New(
+				env,
+				"Expected 2 Parameter(s) to be passed [ Number, String ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	uint32_t capacity = info[0].As<Napi::Number>().Uint32Value();
+	std::string policy = info[1].As<Napi::String>();
+
+	if(capacity == 0){
+		Napi::RangeError::New(
+				env,
+				"Queue capacity must be greater than 0"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	if(policy == "block"){
+		cycle_queue_policy = QUEUE_BLOCK;
+	} else if(policy == "drop-oldest"){
+		cycle_queue_policy = QUEUE_DROP_OLDEST;
+	} else if(policy == "drop-newest"){
+		cycle_queue_policy = QUEUE_DROP_NEWEST;
+	} else if(policy == "coalesce"){
+		cycle_queue_policy = QUEUE_COALESCE;
+	} else {
+		Napi::TypeError::New(
+				env,
+				"\"" + policy + "\" is invalid value. Policy must be "
+				+ "\"block\", \"drop-oldest\", \"drop-newest\" or \"coalesce\""
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	cycle_queue_capacity = capacity;
+
+	return Napi::Boolean::New(env, true);
+}
+
+Napi::Value js_get_queue_stats(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	std::lock_guard<std::mutex> lock(cycle_queue.mutex);
+
+	Napi::Object stats = Napi::Object::New(env);
+	stats.Set("capacity", Napi::Number::New(env, cycle_queue.capacity));
+	stats.Set("pending", Napi::Number::New(env, cycle_queue.count));
+	stats.Set("delivered", Napi::Number::New(env, cycle_queue.delivered));
+	stats.Set("dropped", Napi::Number::New(env, cycle_queue.dropped));
+	stats.Set("coalesced", Napi::Number::New(env, cycle_queue.coalesced));
+
+	return stats;
+}
+
+Napi::Value js_get_operational_status(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	return Napi::Number::New(env, check_is_operational());
+}
+
+Napi::Value js_stop_thread(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+	_running_state = 0;
+
+	return Napi::Number::New(env, _running_state);
+}
+
+Napi::Value js_write_index(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	// don't execute when main task is not running
+	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+		|| _running_state != 1
+		|| IOs_length <= 0
+	){
+		return Napi::Number::New(env, -1);
+	}
+
+	io_size_et dmn_idx = info[0].As<Napi::Number>();
+
+	if(dmn_idx < 0 || dmn_idx >= IOs_length){
+		return Napi::Number::New(env, -1);
+	}
+
+	ecat_value_al raw;
+	if(!entry_value_from_js(IOs[dmn_idx], info[1], &raw)){
+		throw_invalid_entry_value(env);
+
+		return env.Null();
+	}
+
+	IOs[dmn_idx].writtenValue = raw;
+
+	return entry_value_to_js(env, IOs[dmn_idx], IOs[dmn_idx].writtenValue);
+}
+
+Napi::Value js_read_index(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
+	// don't execute when main task is not running
+	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+		|| _running_state != 1
+		|| IOs_length <= 0
+	){
+		return env.Null();
+	}
+
+	io_size_et dmn_idx = info[0].As<Napi::Number>();
+
+	if(dmn_idx < 0 || dmn_idx >= IOs_length){
+		return env.Undefined();
+	}
+
+	return entry_value_to_js(env, IOs[dmn_idx], IOs[dmn_idx].value);
 }
 
-/****************************************************************************
- * Node API
- ****************************************************************************/
-
-Napi::Value js_init_slave(const Napi::CallbackInfo& info)
+Napi::Value js_read_indexes(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	do_sort_slave = 0;
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
 
-	if (info.Length() < 1 || !info[0].IsString()){
+	if (info.Length() < 2
+		|| !info[0].IsTypedArray() || !info[1].IsTypedArray()
+		|| info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array
+		|| info[1].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array
+	){
 		Napi::TypeError::New(
 				env,
-				"Expected 1 Parameter(s) to be passed [ String ]"
+				"Expected 2 Parameter(s) to be passed [ Uint32Array, Float64Array ]"
 			).ThrowAsJavaScriptException();
 
 		return env.Null();
 	}
 
-	if (slave_entries_length > 0){
-		Napi::TypeError::New(
+	Napi::Uint32Array indexes = info[0].As<Napi::Uint32Array>();
+	Napi::Float64Array values = info[1].As<Napi::Float64Array>();
+
+	size_t length = indexes.ElementLength();
+
+	if(values.ElementLength() < length){
+		Napi::RangeError::New(
 				env,
-				"Slaves are already initialized!"
+				"Output array must be at least as long as index array"
 			).ThrowAsJavaScriptException();
 
 		return env.Null();
 	}
 
-	if (info.Length() == 2){
-		do_sort_slave = info[1].As<Napi::Boolean>() ? true : false;
+	// don't execute when main task is not running
+	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+		|| _running_state != 1
+		|| IOs_length <= 0
+	){
+		return env.Null();
 	}
 
-	json_path = info[0].As<Napi::String>();
+	const uint32_t *p_indexes = indexes.Data();
+	double *p_values = values.Data();
+	uint32_t seq;
 
-	int8_t parsing = init_slave();
+	// read until all values come from the same cycle
+	do {
+		while((seq = IOs_seq.load(std::memory_order_acquire)) & 1){
+			std::this_thread::yield();
+		}
 
-	init_master_and_domain();
+		for(size_t i_idx = 0; i_idx < length; i_idx++){
+			p_values[i_idx] = p_indexes[i_idx] < (uint32_t) IOs_length
+								? entry_value_to_double(
+										IOs[p_indexes[i_idx]],
+										IOs[p_indexes[i_idx]].value
+									)
+								: NAN;
+		}
 
-	return Napi::Number::New(env, parsing);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while(seq != IOs_seq.load(std::memory_order_relaxed));
+
+	return values;
 }
 
-Napi::Value js_create_thread(const Napi::CallbackInfo &info)
+Napi::Value js_resolve_domain(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	// Construct context data
-	auto _ctx = new TsfnContext(env);
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
 
-	// Create a new ThreadSafeFunction.
-	_ctx->tsfn = Napi::ThreadSafeFunction::New(
-			env, // Environment
-			info[0].As<Napi::Function>(), // JS function from caller
-			"TSFN", // Resource name
-			0, // Max queue size (0 = unlimited).
-			2, // Initial thread count
-			_ctx, // Context,
-			finalizer_callback, // Finalizer
-			(void *)nullptr	// Finalizer data
-		);
+	if(mapped_keys.empty()){
+		return env.Undefined();
+	}
 
-	_ctx->nativeThread = std::thread(thread_entry, _ctx);
+	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
+	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
+	ecat_sub_al subindex = info[2].As<Napi::Number>().Uint32Value();
 
-	return _ctx->deferred.Promise();
+	io_size_et dmn_idx;
+	if(get_domain_index(&dmn_idx, pos, index, subindex) < 0){
+		return env.Undefined();
+	}
+
+	return Napi::Number::New(env, dmn_idx);
 }
 
-Napi::Value js_set_frequency(const Napi::CallbackInfo& info)
+Napi::Value js_write_by_key(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	uint32_t frequency = info[0].As<Napi::Number>();
+	if(!claim_master(env)){
+		return env.Null();
+	}
 
-	FREQUENCY = frequency;
-	PERIOD_NS = NSEC_PER_SEC / FREQUENCY;
+	// don't execute when main task is not running
+	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+		|| _running_state != 1
+		|| IOs_length <= 0
+	){
+		return env.Null();
+	}
 
-	return Napi::Number::New(env, PERIOD_NS);
-}
+	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
+	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
+	ecat_sub_al subindex = info[2].As<Napi::Number>().Uint32Value();
 
-Napi::Value set_period_us(const Napi::CallbackInfo& info)
-{
-	Napi::Env env = info.Env();
+	io_size_et dmn_idx;
+	if(get_domain_index(&dmn_idx, pos, index, subindex) < 0){
+		return env.Undefined();
+	}
 
-	uint32_t period_us = info[0].As<Napi::Number>();
+	ecat_value_al raw;
+	if(!entry_value_from_js_scaled(IOs[dmn_idx], info[3], &raw)){
+		throw_invalid_entry_value(env);
 
-	PERIOD_NS = period_us * 1000;
-	FREQUENCY = NSEC_PER_SEC / (float(period_us) * 1000);
+		return env.Null();
+	}
 
-	return Napi::Number::New(env, PERIOD_NS);
+	if(write_domain(dmn_idx, raw) < 0){
+		return env.Undefined();
+	}
+
+	return Napi::Boolean::New(env, true);
 }
 
-Napi::Value js_get_operational_status(const Napi::CallbackInfo& info)
+Napi::Value js_read_by_key(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	return Napi::Number::New(env, check_is_operational());
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
+	// don't execute when main task is not running
+	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
+		|| _running_state != 1
+		|| IOs_length <= 0
+	){
+		return env.Null();
+	}
+
+	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
+	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
+	ecat_sub_al subindex = (ecat_sub_al) info[2].As<Napi::Number>().Uint32Value();
+	ecat_value_al value;
+
+	io_size_et dmn_idx;
+	if(get_domain_index(&dmn_idx, pos, index, subindex) < 0){
+		return env.Undefined();
+	}
+
+	if(read_domain(dmn_idx, &value) < 0){
+		return env.Undefined();
+	}
+
+	return entry_value_to_js(env, IOs[dmn_idx], value);
 }
 
-Napi::Value js_stop_thread(const Napi::CallbackInfo& info)
+Napi::Value js_resolve_name(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
-	_running_state = 0;
 
-	return Napi::Number::New(env, _running_state);
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
+	if (info.Length() < 1 || !info[0].IsString()){
+		Napi::TypeError::New(
+				env,
+				"Expected 1 Parameter(s) to be passed [ String ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
+	io_size_et dmn_idx;
+	if(get_named_domain_index(&dmn_idx, info[0].As<Napi::String>()) < 0){
+		return env.Undefined();
+	}
+
+	return Napi::Number::New(env, dmn_idx);
 }
 
-Napi::Value js_write_index(const Napi::CallbackInfo& info)
+Napi::Value js_write_by_name(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
+	if(!claim_master(env)){
+		return env.Null();
+	}
+
+	if (info.Length() < 2 || !info[0].IsString()){
+		Napi::TypeError::New(
+				env,
+				"Expected 2 Parameter(s) to be passed [ String, Number ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
 	// don't execute when main task is not running
 	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
 		|| _running_state != 1
 		|| IOs_length <= 0
 	){
-		return Napi::Number::New(env, -1);
+		return env.Null();
 	}
 
-	io_size_et dmn_idx = info[0].As<Napi::Number>();
-	ecat_value_al value = info[1].As<Napi::Number>();
+	io_size_et dmn_idx;
+	if(get_named_domain_index(&dmn_idx, info[0].As<Napi::String>()) < 0){
+		return env.Undefined();
+	}
 
-	IOs[dmn_idx].writtenValue = value;
+	ecat_value_al raw;
+	if(!entry_value_from_js_scaled(IOs[dmn_idx], info[1], &raw)){
+		throw_invalid_entry_value(env);
+
+		return env.Null();
+	}
+
+	if(write_domain(dmn_idx, raw) < 0){
+		return env.Undefined();
+	}
 
-	return Napi::Number::New(env, IOs[dmn_idx].writtenValue);
+	return Napi::Boolean::New(env, true);
 }
 
-Napi::Value js_write_by_key(const Napi::CallbackInfo& info)
+Napi::Value js_read_by_name(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
+	if (info.Length() < 1 || !info[0].IsString()){
+		Napi::TypeError::New(
+				env,
+				"Expected 1 Parameter(s) to be passed [ String ]"
+			).ThrowAsJavaScriptException();
+
+		return env.Null();
+	}
+
 	// don't execute when main task is not running
 	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
 		|| _running_state != 1
@@ -1379,22 +3626,28 @@ Napi::Value js_write_by_key(const Napi::CallbackInfo& info)
 		return env.Null();
 	}
 
-	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
-	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
-	ecat_sub_al subindex = info[2].As<Napi::Number>().Uint32Value();
-	ecat_value_al value = info[3].As<Napi::Number>().Uint32Value();
+	io_size_et dmn_idx;
+	ecat_value_al value;
 
-	if(write_domain(pos, index, subindex, value) < 0){
+	if(get_named_domain_index(&dmn_idx, info[0].As<Napi::String>()) < 0){
 		return env.Undefined();
 	}
 
-	return Napi::Boolean::New(env, true);
+	if(read_domain(dmn_idx, &value) < 0){
+		return env.Undefined();
+	}
+
+	return entry_value_to_js(env, IOs[dmn_idx], value);
 }
 
-Napi::Value js_read_by_key(const Napi::CallbackInfo& info)
+Napi::Value js_get_named_values(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
 	// don't execute when main task is not running
 	if(!MASTER_STATE_DETAIL(AL_BIT_OP, master_state.al_states)
 		|| _running_state != 1
@@ -1403,23 +3656,41 @@ Napi::Value js_read_by_key(const Napi::CallbackInfo& info)
 		return env.Null();
 	}
 
-	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
-	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
-	ecat_sub_al subindex = (ecat_sub_al) info[2].As<Napi::Number>().Uint32Value();
-	ecat_value_al value;
+	size_t length = named_domains.size();
+	std::vector<ecat_value_al> values(length);
+	uint32_t seq;
 
-	if(read_domain(pos, index, subindex, &value) < 0){
-		return env.Undefined();
+	// read until all values come from the same cycle
+	do {
+		while((seq = IOs_seq.load(std::memory_order_acquire)) & 1){
+			std::this_thread::yield();
+		}
+
+		for(size_t i_name = 0; i_name < length; i_name++){
+			values[i_name] = IOs[named_domains[i_name].dmn_idx].value;
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while(seq != IOs_seq.load(std::memory_order_relaxed));
+
+	Napi::Object snapshot = Napi::Object::New(env);
+	for(size_t i_name = 0; i_name < length; i_name++){
+		snapshot.Set(*named_domains[i_name].name,
+			entry_value_to_js(env, IOs[named_domains[i_name].dmn_idx], values[i_name]));
 	}
 
-	return Napi::Number::New(env, value);
+	return snapshot;
 }
 
 Napi::Value js_get_mapped_domains(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	if(mapped_domains.empty()){
+	if(!check_master_owner(env)){
+		return env.Null();
+	}
+
+	if(mapped_keys.empty()){
 		return env.Undefined();
 	}
 
@@ -1429,18 +3700,20 @@ Napi::Value js_get_mapped_domains(const Napi::CallbackInfo& info)
 	ecat_sub_al subindex;
 	bool do_print = info[0].As<Napi::Boolean>();
 
-	for(auto elem : mapped_domains){
-		pos = (elem.first >> 24) & 0xff;
-		index = (elem.first >> 8) & 0xffff;
-		subindex = (elem.first) & 0xff;
+	for(size_t i_pos = 0; i_pos + 1 < mapped_ranges.size(); i_pos++){
+		for(uint32_t i_key = mapped_ranges[i_pos]; i_key < mapped_ranges[i_pos + 1]; i_key++){
+			pos = i_pos;
+			index = (mapped_keys[i_key] >> 8) & 0xffff;
+			subindex = (mapped_keys[i_key]) & 0xff;
 
-		char tmpstr[30];
-		sprintf(tmpstr, "%d:%04x:%02x", pos, index, subindex);
-		js_retval.Set(tmpstr, Napi::Number::New(env, elem.second));
+			char tmpstr[30];
+			sprintf(tmpstr, "%d:%04x:%02x", pos, index, subindex);
+			js_retval.Set(tmpstr, Napi::Number::New(env, mapped_indexes[i_key]));
 
-		if(do_print){
-			fprintf(stdout, "Pos %d at 0x%04x:%02x = %d\n", pos, index,
-				subindex, elem.second);
+			if(do_print){
+				fprintf(stdout, "Pos %d at 0x%04x:%02x = %d\n", pos, index,
+					subindex, mapped_indexes[i_key]);
+			}
 		}
 	}
 
@@ -1453,6 +3726,12 @@ Napi::Promise js_get_allocated_domain(const Napi::CallbackInfo& info)
 
 	auto deferred = Napi::Promise::Deferred::New(env);
 
+	if(!is_master_readable()){
+		deferred.Reject(Napi::Error::New(env, MASTER_OWNER_ERROR).Value());
+
+		return deferred.Promise();
+	}
+
 	// check if domain have been allocated or not
 	if(IOs_length == 0){
 		deferred.Reject(
@@ -1477,8 +3756,15 @@ Napi::Promise js_get_allocated_domain(const Napi::CallbackInfo& info)
 		item.Set("size", Napi::Value::From(env, IOs[dmn_idx].size));
 		item.Set("isEndianSwapped", Napi::Value::From(env, IOs[dmn_idx].SWAP_ENDIAN));
 		item.Set("isSigned", Napi::Value::From(env, IOs[dmn_idx].SIGNED));
+		item.Set("type", Napi::String::New(env, entry_type_name(IOs[dmn_idx].type)));
+		item.Set("scale", Napi::Number::New(env, IOs[dmn_idx].scale));
+		item.Set("offset", Napi::Number::New(env, IOs[dmn_idx].scale_offset));
 		item.Set("direction", Napi::Value::From(env, IOs[dmn_idx].direction));
-		item.Set("value", Napi::Value::From(env, IOs[dmn_idx].value));
+		item.Set("value", entry_value_to_js(env, IOs[dmn_idx], IOs[dmn_idx].value));
+
+		if(IOs[dmn_idx].name_id != ENTRY_NAME_NONE){
+			item.Set("name", Napi::String::New(env, entry_names[IOs[dmn_idx].name_id]));
+		}
 
 		_domains[dmn_idx] = item;
 	}
@@ -1494,6 +3780,12 @@ Napi::Promise js_get_domain_values(const Napi::CallbackInfo& info)
 
 	auto deferred = Napi::Promise::Deferred::New(env);
 
+	if(!is_master_readable()){
+		deferred.Reject(Napi::Error::New(env, MASTER_OWNER_ERROR).Value());
+
+		return deferred.Promise();
+	}
+
 	// check if domain have been allocated or not
 	if(IOs_length == 0){
 		deferred.Reject(
@@ -1513,7 +3805,7 @@ Napi::Promise js_get_domain_values(const Napi::CallbackInfo& info)
 		indexValue.Set("position", Napi::Value::From(env, IOs[dmn_idx].position));
 		indexValue.Set("index", Napi::Value::From(env, IOs[dmn_idx].index));
 		indexValue.Set("subindex", Napi::Value::From(env, IOs[dmn_idx].subindex));
-		indexValue.Set("value", Napi::Value::From(env, IOs[dmn_idx].value));
+		indexValue.Set("value", entry_value_to_js(env, IOs[dmn_idx], IOs[dmn_idx].value));
 
 		values[dmn_idx] = indexValue;
 	}
@@ -1529,86 +3821,136 @@ Napi::Value js_get_master_state(const Napi::CallbackInfo& info)
 	return Napi::Number::New(env, master_state.al_states);
 }
 
-Napi::Value js_sdo_request_read(const Napi::CallbackInfo& info)
+Napi::Value js_get_cycle_timing(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	ecat_pos_al pos = info[0].As<Napi::Number>().Uint32Value();
-	ecat_index_al index = info[1].As<Napi::Number>().Uint32Value();
-	ecat_sub_al subindex = info[2].As<Napi::Number>().Uint32Value();
-	ecat_size_al size = info[3].As<Napi::Number>().Uint32Value();
+	Napi::Object timing = Napi::Object::New(env);
+	timing.Set("latency", Napi::Number::New(env, cycle_timing.latency.value()));
+	timing.Set("jitter", Napi::Number::New(env, cycle_timing.jitter.value()));
+	timing.Set("delivery", Napi::Number::New(env, cycle_timing.delivery.value()));
+	timing.Set("processing", Napi::Number::New(env, cycle_timing.processing.value()));
+
+	return timing;
+}
 
-	sdo_req_type_al rtype = ECAT_SDO_READ;
+Napi::Value js_get_startup_report(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
 
-	uint32_t timeout = 100;
-	uint8_t verbosity = 0;
-	Unit32b tmp;
+	Napi::Object phases = Napi::Object::New(env);
+	int64_t total_ns = 0;
 
-	if(info.Length() > 4 && info[4].IsNumber()){
-		timeout = info[4].As<Napi::Number>().Uint32Value();
+	for(uint8_t phase = 0; phase < PHASE_COUNT; phase++){
+		int64_t duration_ns = startup_phases[phase].load(std::memory_order_relaxed);
+
+		if(duration_ns == STARTUP_PHASE_NONE){
+			phases.Set(startup_phase_names[phase], env.Null());
+			continue;
+		}
+
+		phases.Set(startup_phase_names[phase], Napi::Number::New(env, duration_ns));
+		total_ns += duration_ns;
 	}
 
-	if(info.Length() > 5 && info[5].IsNumber()){
-		verbosity = info[5].As<Napi::Number>().Uint32Value();
+	Napi::Object report = Napi::Object::New(env);
+	report.Set("phases", phases);
+	report.Set("total", Napi::Number::New(env, total_ns));
+	report.Set("isOperational", Napi::Boolean::New(env,
+		startup_phases[PHASE_OPERATIONAL].load(std::memory_order_relaxed) != STARTUP_PHASE_NONE));
+
+	return report;
+}
+
+Napi::Value js_sdo_request_read(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+
+	if(!claim_master(env)){
+		return env.Null();
 	}
 
-	if((sdo_request(rtype, &tmp, pos, index, subindex, size, timeout, verbosity)) != 0){
-		return env.Undefined();
+	SdoJob *job = new SdoJob(env);
+
+	job->rtype = ECAT_SDO_READ;
+	job->position = info[0].As<Napi::Number>().Uint32Value();
+	job->index = info[1].As<Napi::Number>().Uint32Value();
+	job->subindex = info[2].As<Napi::Number>().Uint32Value();
+	job->size = info[3].As<Napi::Number>().Uint32Value();
+
+	if(info.Length() > 4 && info[4].IsNumber()){
+		job->timeout = info[4].As<Napi::Number>().Uint32Value();
 	}
 
-	switch(size){
-		case 1: return Napi::Number::New(env, tmp.byte);
-		case 2: return Napi::Number::New(env, tmp.word);
-		case 3: return Napi::Number::New(env, tmp.dword);
-		default: return Napi::Number::New(env, tmp.dword);
+	if(info.Length() > 5 && info[5].IsNumber()){
+		job->verbosity = info[5].As<Napi::Number>().Uint32Value();
 	}
+
+	return sdo_job_enqueue(env, job);
 }
 
 Napi::Value js_sdo_request_write(const Napi::CallbackInfo& info)
 {
 	Napi::Env env = info.Env();
 
-	Unit32b tmp;
-	tmp.dword = info[0].As<Napi::Number>().Uint32Value();
+	if(!claim_master(env)){
+		return env.Null();
+	}
 
-	ecat_pos_al pos = info[1].As<Napi::Number>().Uint32Value();
-	ecat_index_al index = info[2].As<Napi::Number>().Uint32Value();
-	ecat_sub_al subindex = info[3].As<Napi::Number>().Uint32Value();
-	ecat_size_al size = info[4].As<Napi::Number>().Uint32Value();
+	SdoJob *job = new SdoJob(env);
 
-	sdo_req_type_al rtype = ECAT_SDO_WRITE;
+	job->rtype = ECAT_SDO_WRITE;
+	job->data.dword = info[0].As<Napi::Number>().Uint32Value();
+	job->position = info[1].As<Napi::Number>().Uint32Value();
+	job->index = info[2].As<Napi::Number>().Uint32Value();
+	job->subindex = info[3].As<Napi::Number>().Uint32Value();
+	job->size = info[4].As<Napi::Number>().Uint32Value();
 
-	uint32_t timeout = 100;
-	uint8_t verbosity = 0;
 	if(info.Length() > 5 && info[5].IsNumber()){
-		timeout = info[5].As<Napi::Number>().Uint32Value();
+		job->timeout = info[5].As<Napi::Number>().Uint32Value();
 	}
 
 	if(info.Length() > 6 && info[6].IsNumber()){
-		verbosity = info[6].As<Napi::Number>().Uint32Value();
+		job->verbosity = info[6].As<Napi::Number>().Uint32Value();
 	}
 
-	if((sdo_request(rtype, &tmp, pos, index, subindex, size, timeout, verbosity)) != 0){
-		return env.Undefined();
-	}
-
-	switch(size){
-		case 1: return Napi::Number::New(env, tmp.byte);
-		case 2: return Napi::Number::New(env, tmp.word);
-		case 3: return Napi::Number::New(env, tmp.dword);
-		default: return Napi::Number::New(env, tmp.dword);
-	}
+	return sdo_job_enqueue(env, job);
 }
 
 Napi::Object Init(Napi::Env env, Napi::Object exports)
 {
+	AddonData *data = new AddonData();
+	data->id = ++addon_data_counter;
+	env_id = data->id;
+	env.SetInstanceData<AddonData, addon_data_finalize>(data);
+
+	// first environment, no startup has run yet
+	if(data->id == 1){
+		reset_startup_phases();
+	}
+
 	exports.Set(Napi::String::New(env, "init"), Napi::Function::New(env, js_init_slave));
+	exports.Set(Napi::String::New(env, "compile"), Napi::Function::New(env, js_compile_config));
+	exports.Set(Napi::String::New(env, "scan"), Napi::Function::New(env, js_scan_bus));
+	exports.Set(Napi::String::New(env, "reconfigure"), Napi::Function::New(env, js_reconfigure));
+	exports.Set(Napi::String::New(env, "planCapacity"), Napi::Function::New(env, js_plan_capacity));
 	exports.Set(Napi::String::New(env, "writeIndex"), Napi::Function::New(env, js_write_index));
+	exports.Set(Napi::String::New(env, "readIndex"), Napi::Function::New(env, js_read_index));
+	exports.Set(Napi::String::New(env, "readIndexes"), Napi::Function::New(env, js_read_indexes));
+	exports.Set(Napi::String::New(env, "resolve"), Napi::Function::New(env, js_resolve_domain));
+	exports.Set(Napi::String::New(env, "resolveName"), Napi::Function::New(env, js_resolve_name));
+	exports.Set(Napi::String::New(env, "readName"), Napi::Function::New(env, js_read_by_name));
+	exports.Set(Napi::String::New(env, "writeName"), Napi::Function::New(env, js_write_by_name));
+	exports.Set(Napi::String::New(env, "getNamedValues"), Napi::Function::New(env, js_get_named_values));
 	exports.Set(Napi::String::New(env, "isOperational"), Napi::Function::New(env, js_get_operational_status));
 	exports.Set(Napi::String::New(env, "start"), Napi::Function::New(env, js_create_thread));
 	exports.Set(Napi::String::New(env, "stop"), Napi::Function::New(env, js_stop_thread));
 	exports.Set(Napi::String::New(env, "getAllocatedDomain"), Napi::Function::New(env, js_get_allocated_domain));
 	exports.Set(Napi::String::New(env, "getMasterState"), Napi::Function::New(env, js_get_master_state));
+	exports.Set(Napi::String::New(env, "getCycleTiming"), Napi::Function::New(env, js_get_cycle_timing));
+	exports.Set(Napi::String::New(env, "getStartupReport"), Napi::Function::New(env, js_get_startup_report));
+	exports.Set(Napi::String::New(env, "setQueuePolicy"), Napi::Function::New(env, js_set_queue_policy));
+	exports.Set(Napi::String::New(env, "getQueueStats"), Napi::Function::New(env, js_get_queue_stats));
 	exports.Set(Napi::String::New(env, "getDomainValues"), Napi::Function::New(env, js_get_domain_values));
 	exports.Set(Napi::String::New(env, "setFrequency"), Napi::Function::New(env, js_set_frequency));
 	exports.Set(Napi::String::New(env, "writeDomain"), Napi::Function::New(env, js_write_by_key));
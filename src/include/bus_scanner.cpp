@@ -0,0 +1,243 @@
+#include <cstdio>
+#include <stdexcept>
+#include "bus_scanner.h"
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <unistd.h>
+
+typedef rapidjson::PrettyWriter<rapidjson::StringBuffer> scanWriter;
+
+/*****************************************************************************/
+
+// identifiers are written as hex strings, same as hand-written configuration
+static void _write_hex(scanWriter &writer, uint32_t value, int digits)
+{
+	char hex[16];
+	snprintf(hex, sizeof(hex), "0x%0*x", digits, value);
+
+	writer.String(hex);
+}
+
+// slave entry with slave, SM and PDO attributes, without PDO entry
+static slaveEntry _scanned_entry(const ec_slave_info_t &slave, uint16_t position,
+	const ec_sync_info_t *sync, uint16_t pdo_index)
+{
+	slaveEntry entry = {};
+
+	entry.alias = slave.alias;
+	entry.position = position;
+	entry.vendor_id = slave.vendor_id;
+	entry.product_code = slave.product_code;
+
+	if(sync != NULL){
+		entry.sync_index = sync->index;
+		entry.direction = sync->dir;
+		entry.WATCHDOG_ENABLED = sync->watchdog_mode == EC_WD_ENABLE;
+	}
+
+	entry.pdo_index = pdo_index;
+	entry.type = ECAT_TYPE_UINT;
+	entry.scale = 1;
+	entry.name_id = ENTRY_NAME_NONE;
+
+	return entry;
+}
+
+static void _wait_bus_scan(ec_master_t *master, ec_master_info_t *master_info)
+{
+	uint32_t waited_ms = 0;
+
+	// slaves are not accessible until master has finished scanning the bus
+	while(true){
+		if(ecrt_master(master, master_info)){
+			throw std::runtime_error("Failed reading master information");
+		}
+
+		if(!master_info->scan_busy){
+			return;
+		}
+
+		if(waited_ms >= BUS_SCAN_TIMEOUT_MS){
+			throw std::runtime_error("Timeout waiting for master to finish bus scan");
+		}
+
+		usleep(10000);
+		waited_ms += 10;
+	}
+}
+
+static void _scan_slave(ec_master_t *master, uint16_t position, scanWriter &writer,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length)
+{
+	const std::string at_slave = " of slave at position " + std::to_string(position);
+
+	ec_slave_info_t slave;
+	if(ecrt_master_get_slave(master, position, &slave)){
+		throw std::runtime_error("Failed reading information" + at_slave);
+	}
+
+	size_t first_entry = slave_entries.size();
+
+	writer.StartObject();
+
+	writer.Key("alias");
+	writer.Uint(slave.alias);
+	writer.Key("position");
+	writer.Uint(position);
+	writer.Key("vendor_id");
+	_write_hex(writer, slave.vendor_id, 8);
+	writer.Key("product_code");
+	_write_hex(writer, slave.product_code, 8);
+
+	bool has_syncs = false;
+
+	for(uint8_t sync_index = 0; sync_index < slave.sync_count; sync_index++){
+		ec_sync_info_t sync;
+		if(ecrt_master_get_sync_manager(master, position, sync_index, &sync)){
+			throw std::runtime_error("Failed reading SM " + std::to_string(sync_index)
+				+ at_slave);
+		}
+
+		// mailbox SMs don't carry process data
+		if(sync.n_pdos == 0){
+			continue;
+		}
+
+		if(!has_syncs){
+			writer.Key("syncs");
+			writer.StartArray();
+			has_syncs = true;
+		}
+
+		writer.StartObject();
+		writer.Key("index");
+		writer.Uint(sync.index);
+		writer.Key("direction");
+		writer.String(sync.dir == EC_DIR_INPUT ? "input" : "output");
+		writer.Key("watchdog_enabled");
+		writer.Bool(sync.watchdog_mode == EC_WD_ENABLE);
+		writer.Key("pdos");
+		writer.StartArray();
+
+		for(uint16_t pdo_pos = 0; pdo_pos < sync.n_pdos; pdo_pos++){
+			ec_pdo_info_t pdo;
+			if(ecrt_master_get_pdo(master, position, sync_index, pdo_pos, &pdo)){
+				throw std::runtime_error("Failed reading PDO " + std::to_string(pdo_pos)
+					+ " of SM " + std::to_string(sync_index) + at_slave);
+			}
+
+			writer.StartObject();
+			writer.Key("index");
+			_write_hex(writer, pdo.index, 4);
+			writer.Key("entries");
+			writer.StartArray();
+
+			for(uint16_t entry_pos = 0; entry_pos < pdo.n_entries; entry_pos++){
+				ec_pdo_entry_info_t info;
+				if(ecrt_master_get_pdo_entry(master, position, sync_index, pdo_pos,
+					entry_pos, &info)
+				){
+					throw std::runtime_error("Failed reading entry "
+						+ std::to_string(entry_pos) + " of PDO "
+						+ std::to_string(pdo_pos) + at_slave);
+				}
+
+				if(info.bit_length < 1 || info.bit_length > 64){
+					throw std::invalid_argument("Entry of PDO " + std::to_string(pdo_pos)
+						+ at_slave + " has unsupported size "
+						+ std::to_string(info.bit_length));
+				}
+
+				// gaps don't have object to be registered into domain
+				bool add_to_domain = info.index != 0;
+
+				writer.StartObject();
+				writer.Key("index");
+				_write_hex(writer, info.index, 4);
+				writer.Key("subindex");
+				_write_hex(writer, info.subindex, 2);
+				writer.Key("size");
+				writer.Uint(info.bit_length);
+				writer.Key("add_to_domain");
+				writer.Bool(add_to_domain);
+				writer.EndObject();
+
+				slaveEntry entry = _scanned_entry(slave, position, &sync, pdo.index);
+				entry.index = info.index;
+				entry.subindex = info.subindex;
+				entry.size = info.bit_length;
+				entry.add_to_domain = add_to_domain;
+
+				(*slave_length)++;
+				slave_entries.push_back(entry);
+			}
+
+			// add new slave entry if pdo doesnt have entries
+			if(pdo.n_entries == 0){
+				(*slave_length)++;
+				slave_entries.push_back(_scanned_entry(slave, position, &sync, pdo.index));
+			}
+
+			writer.EndArray();
+			writer.EndObject();
+		}
+
+		writer.EndArray();
+		writer.EndObject();
+	}
+
+	if(has_syncs){
+		writer.EndArray();
+	}
+
+	writer.EndObject();
+
+	// add new slave entry if slave doesnt have syncs
+	if(slave_entries.size() == first_entry){
+		(*slave_length)++;
+		slave_entries.push_back(_scanned_entry(slave, position, NULL, 0));
+	}
+}
+
+/*****************************************************************************/
+
+int8_t scan_bus(ec_master_t *master, std::string &config_json,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length)
+{
+	*slave_length = 0;
+
+	size_t entries_size = slave_entries.size();
+
+	try {
+		ec_master_info_t master_info;
+		_wait_bus_scan(master, &master_info);
+
+#if DEBUG > 0
+		printf("Scanning %u slave(s)...\n", master_info.slave_count);
+#endif
+
+		rapidjson::StringBuffer buffer;
+		scanWriter writer(buffer);
+		writer.SetIndent('\t', 1);
+
+		writer.StartArray();
+
+		for(uint32_t position = 0; position < master_info.slave_count; position++){
+			_scan_slave(master, position, writer, slave_entries, slave_length);
+		}
+
+		writer.EndArray();
+
+		config_json.assign(buffer.GetString(), buffer.GetSize());
+	} catch (...) {
+		// discard partially scanned slaves
+		slave_entries.resize(entries_size);
+		*slave_length = 0;
+
+		throw;
+	}
+
+	return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef BUS_SCANNER_H
+#define BUS_SCANNER_H
+
+#include <vector>
+#include <string>
+
+#include "ecrt.h"
+#include "config_parser.h"
+
+/** Maximum time to wait for master to finish its own bus scan in ms. */
+#define BUS_SCAN_TIMEOUT_MS 5000
+
+/*****************************************************************************/
+
+// Read slaves, SMs, PDOs and PDO entries of the live bus from master.
+// Slave configuration JSON and slave entries, equal to parse_json() result
+// of that JSON, are produced in a single pass.
+extern int8_t scan_bus(ec_master_t *master, std::string &config_json,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length);
+
+#endif
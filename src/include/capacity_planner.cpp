@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <tuple>
+#include "capacity_planner.h"
+
+/** EtherCAT header in frame. */
+#define ETHERCAT_HEADER_BYTES 2
+
+/** Datagram header and working counter. */
+#define DATAGRAM_OVERHEAD_BYTES 12
+
+/** Smallest Ethernet payload, shorter frames are padded. */
+#define ETHERNET_MIN_PAYLOAD 46
+
+/** Ethernet header, FCS, preamble with SFD and inter frame gap. */
+#define ETHERNET_OVERHEAD_BYTES (14 + 4 + 8 + 12)
+
+/*****************************************************************************/
+
+static uint32_t _wire_time_ns(uint64_t bytes, uint64_t link_speed)
+{
+	return (uint32_t) ((bytes * 8 * 1000000000ULL + link_speed - 1) / link_speed);
+}
+
+static uint32_t _frame_wire_bytes(uint32_t payload)
+{
+	return std::max(payload, (uint32_t) ETHERNET_MIN_PAYLOAD) + ETHERNET_OVERHEAD_BYTES;
+}
+
+/*****************************************************************************/
+
+void plan_capacity(const std::vector<slaveEntry> &slave_entries,
+	const capacityOptions &options, capacityReport &report)
+{
+	// bits of every SM of every slave, and if SM has any domain entry
+	struct syncImage {
+		uint8_t direction;
+		uint32_t bits;
+		bool in_domain;
+	};
+
+	std::map<std::pair<ecat_pos_al, uint8_t>, syncImage> syncs;
+	std::map<ecat_pos_al, slaveLoad> slaves;
+
+	// last mapped entry of every PDO, by position, SM and PDO index
+	std::map<std::tuple<ecat_pos_al, uint8_t, ecat_index_al>, uint64_t> last_entries;
+
+	for(const slaveEntry &entry : slave_entries){
+		slaves[entry.position].position = entry.position;
+
+		// entries without PDO use default configuration, size is unknown
+		if(!entry.pdo_index){
+			continue;
+		}
+
+		syncImage &sync = syncs[std::make_pair(entry.position, entry.sync_index)];
+		sync.direction = entry.direction;
+		sync.in_domain = sync.in_domain || (entry.index && entry.add_to_domain);
+
+		// the same entry listed twice in a row is mapped once, see pdo_config
+		uint64_t entry_key = ((uint64_t) entry.index << 16)
+							| ((uint64_t) entry.subindex << 8) | entry.size;
+		auto last_entry = last_entries.insert(std::make_pair(
+				std::make_tuple(entry.position, entry.sync_index, entry.pdo_index),
+				entry_key
+			));
+
+		if(!last_entry.second){
+			if(last_entry.first->second == entry_key){
+				continue;
+			}
+
+			last_entry.first->second = entry_key;
+		}
+
+		sync.bits += entry.size;
+	}
+
+	report = capacityReport();
+
+	// master maps whole SM image into domain, process data of SM is never
+	// split between datagrams
+	std::vector<uint32_t> datagram_sizes;
+
+	for(const auto &sync : syncs){
+		if(!sync.second.in_domain){
+			continue;
+		}
+
+		uint32_t bytes = (sync.second.bits + 7) / 8;
+		slaveLoad &slave = slaves[sync.first.first];
+
+		if(sync.second.direction == EC_DIR_OUTPUT){
+			slave.output_bytes += bytes;
+			report.output_bytes += bytes;
+		} else {
+			slave.input_bytes += bytes;
+			report.input_bytes += bytes;
+		}
+
+		if(datagram_sizes.empty()
+			|| datagram_sizes.back() + bytes > CAPACITY_DATAGRAM_MAX_DATA
+		){
+			datagram_sizes.push_back(0);
+		}
+
+		datagram_sizes.back() += bytes;
+	}
+
+	report.domain_size = report.input_bytes + report.output_bytes;
+	report.datagrams = datagram_sizes.size();
+
+	// datagrams are packed into as few frames as they fit in
+	uint32_t frame_payload = 0;
+
+	for(uint32_t datagram_size : datagram_sizes){
+		uint32_t datagram_bytes = datagram_size + DATAGRAM_OVERHEAD_BYTES;
+
+		if(frame_payload == 0
+			|| frame_payload + datagram_bytes > CAPACITY_FRAME_MAX_PAYLOAD
+		){
+			if(frame_payload > 0){
+				report.wire_bytes += _frame_wire_bytes(frame_payload);
+			}
+
+			frame_payload = ETHERCAT_HEADER_BYTES;
+			report.frames++;
+		}
+
+		frame_payload += datagram_bytes;
+	}
+
+	if(frame_payload > 0){
+		report.wire_bytes += _frame_wire_bytes(frame_payload);
+	}
+
+	// frames are sent back to back, the last one returns after passing all slaves
+	report.wire_time_ns = _wire_time_ns(report.wire_bytes, options.link_speed);
+	report.bus_time_ns = report.wire_time_ns
+		+ (uint32_t) slaves.size() * options.slave_delay_ns;
+
+	// rounded up to whole microseconds
+	report.min_period_ns = (report.bus_time_ns + 999) / 1000 * 1000;
+
+	if(options.period_ns > 0){
+		report.load = (double) report.bus_time_ns / options.period_ns;
+	}
+
+	report.slaves.reserve(slaves.size());
+
+	for(auto &slave : slaves){
+		slave.second.wire_time_ns = _wire_time_ns(
+				slave.second.input_bytes + slave.second.output_bytes,
+				options.link_speed
+			) + options.slave_delay_ns;
+
+		report.slaves.push_back(slave.second);
+	}
+}
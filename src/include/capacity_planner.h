@@ -0,0 +1,62 @@
+#ifndef CAPACITY_PLANNER_H
+#define CAPACITY_PLANNER_H
+
+#include <vector>
+
+#include "config_parser.h"
+
+/** Default Ethernet link speed in bit/s. */
+#define CAPACITY_LINK_SPEED 100000000ULL
+
+/** Default processing and forwarding delay of one slave in ns. */
+#define CAPACITY_SLAVE_DELAY_NS 1000
+
+/** Maximum data of a datagram filling a whole frame, 1500 - 2 - 10 - 2 bytes. */
+#define CAPACITY_DATAGRAM_MAX_DATA 1486
+
+/** Maximum Ethernet payload, EtherCAT header and datagrams. */
+#define CAPACITY_FRAME_MAX_PAYLOAD 1500
+
+/*****************************************************************************/
+
+typedef struct capacityOptions_s{
+	uint64_t link_speed; /**< Link speed in bit/s. */
+	uint32_t slave_delay_ns; /**< Processing and forwarding delay of one slave. */
+	uint32_t period_ns; /**< Cycle period to check against, 0 if not checked. */
+} capacityOptions;
+
+typedef struct slaveLoad_s{
+	ecat_pos_al position;
+	uint32_t input_bytes; /**< Process data read from slave. */
+	uint32_t output_bytes; /**< Process data written to slave. */
+	uint32_t wire_time_ns; /**< Transmission of its process data plus its delay. */
+} slaveLoad;
+
+typedef struct capacityReport_s{
+	uint32_t domain_size; /**< Process data image in bytes. */
+	uint32_t input_bytes;
+	uint32_t output_bytes;
+
+	uint32_t datagrams; /**< Process data datagrams per cycle. */
+	uint32_t frames; /**< Ethernet frames per cycle. */
+	uint32_t wire_bytes; /**< Bytes on the wire per cycle, preamble and gap included. */
+
+	uint32_t wire_time_ns; /**< Transmission time of all frames. */
+	uint32_t bus_time_ns; /**< Wire time plus delay of all slaves, frames round trip. */
+	uint32_t min_period_ns; /**< Shortest cycle period the frames fit in. */
+
+	double load; /**< Bus time of period, 0 if period is not checked. */
+
+	std::vector<slaveLoad> slaves; /**< Sorted by position. */
+} capacityReport;
+
+/*****************************************************************************/
+
+// Estimate cyclic bus load of parsed slave configuration. Process data of
+// every SM with a domain entry is exchanged by LRW datagrams, like master
+// lays out the domain. Master's own datagrams, e.g. of its state machines,
+// are not included.
+extern void plan_capacity(const std::vector<slaveEntry> &slave_entries,
+	const capacityOptions &options, capacityReport &report);
+
+#endif
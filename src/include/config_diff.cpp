@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <utility>
+#include "config_diff.h"
+
+// items of one slave, in configuration order
+typedef std::vector<std::pair<ecat_pos_al, size_t>> positionIndex;
+
+/*****************************************************************************/
+
+template <typename T, typename GetPosition>
+static positionIndex _index_by_position(const std::vector<T> &items, GetPosition position_of)
+{
+	positionIndex index;
+	index.reserve(items.size());
+
+	for(size_t i_item = 0; i_item < items.size(); i_item++){
+		index.emplace_back(position_of(items[i_item]), i_item);
+	}
+
+	// stable, so items of each slave keep their order
+	std::stable_sort(index.begin(), index.end(),
+		[](const std::pair<ecat_pos_al, size_t> &i1, const std::pair<ecat_pos_al, size_t> &i2){
+			return i1.first < i2.first;
+		});
+
+	return index;
+}
+
+static const std::string &_entry_name(const parsedConfig &config, const slaveEntry &entry)
+{
+	static const std::string unnamed;
+
+	return entry.name_id == ENTRY_NAME_NONE ? unnamed : (*config.names)[entry.name_id];
+}
+
+static bool _is_same_entry(const parsedConfig &c1, const slaveEntry &e1,
+	const parsedConfig &c2, const slaveEntry &e2)
+{
+	return e1.alias == e2.alias
+		&& e1.vendor_id == e2.vendor_id
+		&& e1.product_code == e2.product_code
+		&& e1.sync_index == e2.sync_index
+		&& e1.pdo_index == e2.pdo_index
+		&& e1.index == e2.index
+		&& e1.subindex == e2.subindex
+		&& e1.size == e2.size
+		&& e1.add_to_domain == e2.add_to_domain
+		&& e1.direction == e2.direction
+		&& e1.SWAP_ENDIAN == e2.SWAP_ENDIAN
+		&& e1.SIGNED == e2.SIGNED
+		&& e1.WATCHDOG_ENABLED == e2.WATCHDOG_ENABLED
+		&& e1.type == e2.type
+		&& e1.scale == e2.scale
+		&& e1.scale_offset == e2.scale_offset
+		&& _entry_name(c1, e1) == _entry_name(c2, e2);
+}
+
+static bool _is_same_parameter(const parsedConfig &c1, const startupConfig &p1,
+	const parsedConfig &c2, const startupConfig &p2)
+{
+	bool is_same = p1.index == p2.index
+		&& p1.subindex == p2.subindex
+		&& p1.size == p2.size
+		&& p1.value == p2.value
+		&& p1.type == p2.type
+		&& p1.complete_access == p2.complete_access
+		&& p1.data_length == p2.data_length;
+
+	// string and octets values are compared by content, not by their offset
+	if(is_same && p1.data_length > 0){
+		is_same = std::equal(
+				c1.parameter_data->begin() + p1.data_offset,
+				c1.parameter_data->begin() + p1.data_offset + p1.data_length,
+				c2.parameter_data->begin() + p2.data_offset
+			);
+	}
+
+	return is_same;
+}
+
+// updated parameters of one slave which differ from all of its running ones,
+// most are unchanged and at the same place, so that one is compared first
+static void _add_changed_parameters(const parsedConfig &running,
+	const positionIndex &running_params, std::pair<size_t, size_t> r_params,
+	const parsedConfig &updated, const positionIndex &updated_params,
+	std::pair<size_t, size_t> u_params, std::vector<size_t> &changed_parameters)
+{
+	for(size_t i_param = u_params.first; i_param < u_params.second; i_param++){
+		const startupConfig &parameter = (*updated.parameters)[updated_params[i_param].second];
+		size_t i_same = r_params.first + (i_param - u_params.first);
+
+		bool is_running = i_same < r_params.second && _is_same_parameter(
+				running, (*running.parameters)[running_params[i_same].second],
+				updated, parameter
+			);
+
+		for(size_t i_running = r_params.first; !is_running
+			&& i_running < r_params.second; i_running++){
+			is_running = _is_same_parameter(
+					running, (*running.parameters)[running_params[i_running].second],
+					updated, parameter
+				);
+		}
+
+		if(!is_running){
+			changed_parameters.push_back(updated_params[i_param].second);
+		}
+	}
+}
+
+// range of items of slave at position, starting from cursor
+static std::pair<size_t, size_t> _slave_range(const positionIndex &index, size_t cursor,
+	ecat_pos_al position)
+{
+	size_t end = cursor;
+	while(end < index.size() && index[end].first == position){
+		end++;
+	}
+
+	return std::make_pair(cursor, end);
+}
+
+/*****************************************************************************/
+
+bool diff_config(const parsedConfig &running, const parsedConfig &updated,
+	std::vector<slaveChange> &changes, std::vector<size_t> *changed_parameters)
+{
+	auto entry_position = [](const slaveEntry &entry){ return entry.position; };
+	auto parameter_position = [](const startupConfig &parameter){
+		return parameter.slavePosition;
+	};
+
+	positionIndex running_entries = _index_by_position(*running.entries, entry_position);
+	positionIndex updated_entries = _index_by_position(*updated.entries, entry_position);
+	positionIndex running_params = _index_by_position(*running.parameters, parameter_position);
+	positionIndex updated_params = _index_by_position(*updated.parameters, parameter_position);
+
+	size_t i_running = 0;
+	size_t i_updated = 0;
+	size_t i_running_param = 0;
+	size_t i_updated_param = 0;
+	bool is_hot_applicable = true;
+
+	changes.clear();
+
+	if(changed_parameters != NULL){
+		changed_parameters->clear();
+	}
+
+	// every slave has at least one entry, so slaves are walked by entries
+	while(i_running < running_entries.size() || i_updated < updated_entries.size()){
+		bool has_running = i_running < running_entries.size();
+		bool has_updated = i_updated < updated_entries.size();
+
+		ecat_pos_al position = !has_updated
+			|| (has_running && running_entries[i_running].first < updated_entries[i_updated].first)
+			? running_entries[i_running].first
+			: updated_entries[i_updated].first;
+
+		auto r_entries = _slave_range(running_entries, i_running, position);
+		auto u_entries = _slave_range(updated_entries, i_updated, position);
+
+		// parameters of slaves without entries are ignored, like parse_json() does
+		while(i_running_param < running_params.size()
+			&& running_params[i_running_param].first < position){
+			i_running_param++;
+		}
+
+		while(i_updated_param < updated_params.size()
+			&& updated_params[i_updated_param].first < position){
+			i_updated_param++;
+		}
+
+		auto r_params = _slave_range(running_params, i_running_param, position);
+		auto u_params = _slave_range(updated_params, i_updated_param, position);
+
+		i_running = r_entries.second;
+		i_updated = u_entries.second;
+		i_running_param = r_params.second;
+		i_updated_param = u_params.second;
+
+		uint8_t change = SLAVE_UNCHANGED;
+
+		if(r_entries.first == r_entries.second){
+			change = SLAVE_ADDED;
+		} else if(u_entries.first == u_entries.second){
+			change = SLAVE_REMOVED;
+		} else {
+			bool is_same_layout = r_entries.second - r_entries.first
+								== u_entries.second - u_entries.first;
+
+			for(size_t i_entry = 0; is_same_layout
+				&& i_entry < r_entries.second - r_entries.first; i_entry++){
+				is_same_layout = _is_same_entry(
+						running, (*running.entries)[running_entries[r_entries.first + i_entry].second],
+						updated, (*updated.entries)[updated_entries[u_entries.first + i_entry].second]
+					);
+			}
+
+			bool is_same_params = r_params.second - r_params.first
+								== u_params.second - u_params.first;
+
+			for(size_t i_param = 0; is_same_params
+				&& i_param < r_params.second - r_params.first; i_param++){
+				is_same_params = _is_same_parameter(
+						running, (*running.parameters)[running_params[r_params.first + i_param].second],
+						updated, (*updated.parameters)[updated_params[u_params.first + i_param].second]
+					);
+			}
+
+			if(!is_same_layout){
+				change = SLAVE_LAYOUT_CHANGED;
+			} else if(!is_same_params){
+				change = SLAVE_PARAMETERS_CHANGED;
+
+				if(changed_parameters != NULL){
+					_add_changed_parameters(running, running_params, r_params,
+						updated, updated_params, u_params, *changed_parameters);
+				}
+			}
+		}
+
+		if(change != SLAVE_UNCHANGED){
+			changes.push_back({ position, change });
+		}
+
+		if(change != SLAVE_UNCHANGED && change != SLAVE_PARAMETERS_CHANGED){
+			is_hot_applicable = false;
+		}
+	}
+
+	return is_hot_applicable;
+}
+
+const char *slave_change_name(uint8_t change)
+{
+	switch(change){
+		case SLAVE_UNCHANGED: return "unchanged";
+		case SLAVE_PARAMETERS_CHANGED: return "parameters";
+		case SLAVE_LAYOUT_CHANGED: return "layout";
+		case SLAVE_ADDED: return "added";
+		case SLAVE_REMOVED: return "removed";
+		default: return "unknown";
+	}
+}
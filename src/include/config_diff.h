@@ -0,0 +1,45 @@
+#ifndef CONFIG_DIFF_H
+#define CONFIG_DIFF_H
+
+#include <vector>
+#include <string>
+
+#include "config_parser.h"
+
+/*****************************************************************************/
+
+typedef enum slave_change_en{
+	SLAVE_UNCHANGED = 0,
+	SLAVE_PARAMETERS_CHANGED = 1, /**< Only startup parameters differ. */
+	SLAVE_LAYOUT_CHANGED = 2, /**< Identity, SMs, PDOs or entries differ. */
+	SLAVE_ADDED = 3,
+	SLAVE_REMOVED = 4
+} slave_change_al;
+
+typedef struct slaveChange_s{
+	ecat_pos_al position;
+	uint8_t change; /**< See slave_change_al. */
+} slaveChange;
+
+// Parsed slave configuration, as returned by parse_json()
+typedef struct parsedConfig_s{
+	const std::vector<slaveEntry> *entries;
+	const std::vector<startupConfig> *parameters;
+	const std::vector<uint8_t> *parameter_data;
+	const std::vector<std::string> *names;
+} parsedConfig;
+
+/*****************************************************************************/
+
+// Compare slaves of two configurations by position. Only changed slaves
+// are added to changes, sorted by position. Returns true if every change
+// can be applied without re-initializing master, i.e. parameters only.
+// Indexes of updated parameters of slaves with changed parameters only,
+// which differ from every running parameter of the slave, are added to
+// changed_parameters if it's passed.
+extern bool diff_config(const parsedConfig &running, const parsedConfig &updated,
+	std::vector<slaveChange> &changes, std::vector<size_t> *changed_parameters = NULL);
+
+extern const char *slave_change_name(uint8_t change);
+
+#endif
@@ -1,11 +1,31 @@
 #include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <set>
+#include <map>
 #include "config_parser.h"
+#include "esi_parser.h"
+
+#include "rapidjson/reader.h"
+#include "rapidjson/document.h"
+#include "rapidjson/schema.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/cursorstreamwrapper.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/error/en.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 off_t get_filesize(const char *);
 std::string normalize_hex_string(std::string);
-uint32_t _to_uint(const rapidjson::Value&);
-uint8_t member_is_valid_array(const rapidjson::Value&, const char *);
-bool _slave_entries_sort_asc(slaveEntry, slaveEntry);
+uint64_t _to_uint(const std::string&, const char *);
+uint8_t _to_entry_type(const std::string*, uint8_t, uint8_t);
+uint8_t _to_parameter_type(const std::string*);
+bool _slave_entries_layout_asc(const slaveEntry&, const slaveEntry&);
+uint8_t _entry_alignment(const slaveEntry&);
 
 off_t get_filesize(const char *filename)
 {
@@ -31,288 +51,1932 @@ std::string normalize_hex_string(std::string str)
 	return output;
 }
 
-bool _slave_entries_sort_asc(slaveEntry p1, slaveEntry p2)
+// Sort by position, sync_index, then pdo_index. Entries order inside a PDO
+// is its mapping, so it's kept by stable sort instead of being compared.
+bool _slave_entries_layout_asc(const slaveEntry& p1, const slaveEntry& p2)
 {
-	// sort by position, pdo_index, index, then subindex
-	if(p1.position < p2.position){
-		return true;
+	if(p1.position != p2.position){
+		return p1.position < p2.position;
 	}
 
-	bool c_position = p1.position == p2.position;
-	if(c_position && p1.pdo_index < p2.pdo_index){
-		return true;
+	if(p1.sync_index != p2.sync_index){
+		return p1.sync_index < p2.sync_index;
 	}
 
-	bool c_pdo_index = c_position && p1.pdo_index == p2.pdo_index;
-	if(c_pdo_index && p1.index < p2.index && (p1.index && p2.index)){
-		return true;
+	return p1.pdo_index < p2.pdo_index;
+}
+
+// natural alignment in bits of byte sized entries, 0 for bits and gaps
+uint8_t _entry_alignment(const slaveEntry& entry)
+{
+	bool is_aligned = entry.index && entry.size >= 8
+					&& (entry.size & (entry.size - 1)) == 0;
+
+	return is_aligned ? entry.size : 0;
+}
+
+// hexadecimal string into unsigned integer
+uint64_t _to_uint(const std::string& str, const char *name)
+{
+	std::string hex = str;
+
+	// strip '0x' prefix, its '0' is a valid hex digit
+	if(hex.size() > 1 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')){
+		hex = hex.substr(2);
 	}
 
-	bool c_index = c_pdo_index && p1.index == p2.index && (p1.index && p2.index);
-	if(c_index && p1.subindex < p2.subindex && (p1.subindex && p2.subindex)){
-		return true;
+	hex = normalize_hex_string(hex);
+
+	if(hex.empty() || hex.size() > 16){
+		throw std::invalid_argument(
+			"\"" + str + "\" is invalid value. "
+			+ "'" + name + "' value must be an integer or hexadecimal string"
+		);
 	}
 
-	return false;
+	return std::stoull(hex, 0, 16);
 }
 
-uint32_t _to_uint(const rapidjson::Value& val)
+uint8_t _to_entry_type(const std::string* val, uint8_t size, uint8_t is_signed)
 {
-	if(val.IsString()){
-		return std::stoi(normalize_hex_string(val.GetString()), 0, 16);
-	} else {
-		return val.GetUint();
+	if(size < 1 || size > 64){
+		throw std::invalid_argument(
+			"\"" + std::to_string(size) + "\" is invalid entry size. "
+			+ "'size' value must be between 1 and 64"
+		);
+	}
+
+	// type is not defined, use 'signed' flag
+	if(val == NULL){
+		return is_signed ? ECAT_TYPE_INT : ECAT_TYPE_UINT;
+	}
+
+	std::string type = *val;
+	std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+	if(type == "uint"){
+		return ECAT_TYPE_UINT;
+	}
+
+	if(type == "int"){
+		return ECAT_TYPE_INT;
+	}
+
+	if(type == "bits"){
+		return ECAT_TYPE_BITS;
+	}
+
+	if(type == "real32" || type == "float"){
+		if(size != 32){
+			throw std::invalid_argument("'real32' entry size must be 32");
+		}
+
+		return ECAT_TYPE_REAL32;
+	}
+
+	if(type == "real64" || type == "double"){
+		if(size != 64){
+			throw std::invalid_argument("'real64' entry size must be 64");
+		}
+
+		return ECAT_TYPE_REAL64;
 	}
+
+	throw std::invalid_argument(
+		"\"" + type + "\" is invalid value. "
+		+ "'type' value must be \"uint\", \"int\", \"bits\", \"real32\" or \"real64\""
+	);
 }
 
-uint8_t member_is_valid_array(const rapidjson::Value& doc, const char *name)
+uint8_t _to_parameter_type(const std::string* val)
 {
-	if(!doc.HasMember(name)){
-		return 0;
+	// type is not defined, keep unsigned integer
+	if(val == NULL){
+		return PARAM_TYPE_UINT;
+	}
+
+	std::string type = *val;
+	std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+	if(type == "uint"){
+		return PARAM_TYPE_UINT;
+	}
+
+	if(type == "int"){
+		return PARAM_TYPE_INT;
+	}
+
+	if(type == "real32" || type == "float"){
+		return PARAM_TYPE_REAL32;
 	}
 
-	if(!doc[name].IsArray()){
-		return 0;
+	if(type == "real64" || type == "double"){
+		return PARAM_TYPE_REAL64;
 	}
 
-	return doc[name].Size() > 0 ? 1 : 0;
+	if(type == "string"){
+		return PARAM_TYPE_STRING;
+	}
+
+	if(type == "octets"){
+		return PARAM_TYPE_OCTETS;
+	}
+
+	throw std::invalid_argument(
+		"\"" + type + "\" is invalid value. 'type' value must be \"uint\", "
+		+ "\"int\", \"real32\", \"real64\", \"string\" or \"octets\""
+	);
 }
 
-int8_t parse_json(const char *json_string, std::vector<slaveEntry> &slave_entries,
-	slave_size_et *slave_length, std::vector<startupConfig> &slave_parameters,
-	sparam_size_et *parameters_length, bool do_sort_slave)
-{
+/*****************************************************************************/
 
-	rapidjson::Document document;
-	document.Parse(json_string);
+// position inside slave configuration document
+typedef enum parse_state_en{
+	PARSE_ROOT = 0,
+	PARSE_SLAVES,
+	PARSE_SLAVE,
+	PARSE_SYNCS,
+	PARSE_SYNC,
+	PARSE_PDOS,
+	PARSE_PDO,
+	PARSE_ENTRIES,
+	PARSE_ENTRY,
+	PARSE_PARAMETERS,
+	PARSE_PARAMETER,
+	PARSE_DOCUMENT,
+	PARSE_PROFILES,
+	PARSE_PROFILE,
+	PARSE_DONE
+} parse_state_al;
 
-	assert(document.IsArray());
+typedef enum parse_field_en{
+	FIELD_DOCUMENT_PROFILES = 0,
+	FIELD_DOCUMENT_SLAVES,
 
-	*slave_length = 0;
-	*parameters_length = 0;
+	FIELD_PROFILE_NAME,
+	FIELD_PROFILE_VENDOR_ID,
+	FIELD_PROFILE_PRODUCT_CODE,
+	FIELD_PROFILE_SYNCS,
+	FIELD_PROFILE_PARAMETERS,
 
-	/* ************************************ */
+	FIELD_SLAVE_ALIAS,
+	FIELD_SLAVE_POSITION,
+	FIELD_SLAVE_VENDOR_ID,
+	FIELD_SLAVE_PRODUCT_CODE,
+	FIELD_SLAVE_SYNCS,
+	FIELD_SLAVE_PARAMETERS,
+	FIELD_SLAVE_PROFILE,
+	FIELD_SLAVE_REVISION,
 
-	for (slave_size_et i_slaves = 0; i_slaves < document.Size(); i_slaves++){
-		rapidjson::Value::Object m_slaves = document[i_slaves].GetObject();
+	FIELD_SYNC_INDEX,
+	FIELD_SYNC_WATCHDOG_ENABLED,
+	FIELD_SYNC_DIRECTION,
+	FIELD_SYNC_PDOS,
 
-		assert(m_slaves.HasMember("alias"));
-		assert(m_slaves.HasMember("position"));
-		assert(m_slaves.HasMember("vendor_id"));
-		assert(m_slaves.HasMember("product_code"));
+	FIELD_PDO_INDEX,
+	FIELD_PDO_ENTRIES,
+	FIELD_PDO_REMAPPABLE,
 
-		uint16_t alias = _to_uint(m_slaves["alias"]);
-		ecat_pos_al position = _to_uint(m_slaves["position"]);
-		uint32_t vendor_id = _to_uint(m_slaves["vendor_id"]);
-		uint32_t product_code = _to_uint(m_slaves["product_code"]);
+	FIELD_ENTRY_INDEX,
+	FIELD_ENTRY_SUBINDEX,
+	FIELD_ENTRY_SIZE,
+	FIELD_ENTRY_ADD_TO_DOMAIN,
+	FIELD_ENTRY_SWAP_ENDIAN,
+	FIELD_ENTRY_SIGNED,
+	FIELD_ENTRY_TYPE,
+	FIELD_ENTRY_SCALE,
+	FIELD_ENTRY_OFFSET,
+	FIELD_ENTRY_NAME,
 
-		// add new slave entry if slave doesnt have syncs
-		if(!member_is_valid_array(m_slaves, "syncs")){
-			(*slave_length)++;
-
-			slave_entries.push_back({
-					alias,
-					position,
-					vendor_id,
-					product_code,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0,
-					0
-				});
+	FIELD_PARAMETER_INDEX,
+	FIELD_PARAMETER_SUBINDEX,
+	FIELD_PARAMETER_SIZE,
+	FIELD_PARAMETER_VALUE,
+	FIELD_PARAMETER_TYPE,
+	FIELD_PARAMETER_COMPLETE_ACCESS
+} parse_field_al;
 
-			continue;
-		}
+typedef enum parse_kind_en{
+	KIND_UINT = 0, // integer or hexadecimal string
+	KIND_BOOL,
+	KIND_STRING,
+	KIND_NUMBER,
+	KIND_ARRAY,
+	KIND_VALUE // integer, number or string, converted by parameter type
+} parse_kind_al;
 
-		assert(m_slaves["syncs"].IsArray());
+typedef struct parseField_s{
+	uint8_t state; /**< Object which the member belongs to. */
+	const char *name; /**< Member name. */
+	uint8_t field;
+	uint8_t kind;
+	uint64_t max; /**< Maximum value of KIND_UINT. */
+} parseField;
 
-		for(uint8_t i_syncs = 0; i_syncs < m_slaves["syncs"].Size(); i_syncs++){
-			rapidjson::Value::Object m_syncs = m_slaves["syncs"][i_syncs].GetObject();
+static const parseField parse_fields[] = {
+		{ PARSE_DOCUMENT, "profiles", FIELD_DOCUMENT_PROFILES, KIND_ARRAY, 0 },
+		{ PARSE_DOCUMENT, "slaves", FIELD_DOCUMENT_SLAVES, KIND_ARRAY, 0 },
 
-			assert(m_syncs.HasMember("index"));
-			assert(m_syncs.HasMember("pdos"));
-			assert(m_syncs["pdos"].IsArray());
+		{ PARSE_PROFILE, "name", FIELD_PROFILE_NAME, KIND_STRING, 0 },
+		{ PARSE_PROFILE, "vendor_id", FIELD_PROFILE_VENDOR_ID, KIND_UINT, 0xffffffff },
+		{ PARSE_PROFILE, "product_code", FIELD_PROFILE_PRODUCT_CODE, KIND_UINT, 0xffffffff },
+		{ PARSE_PROFILE, "syncs", FIELD_PROFILE_SYNCS, KIND_ARRAY, 0 },
+		{ PARSE_PROFILE, "parameters", FIELD_PROFILE_PARAMETERS, KIND_ARRAY, 0 },
 
-			uint8_t sync_index = _to_uint(m_syncs["index"]);
-			uint8_t watchdog_enabled = 0;
-			uint8_t direction = SyncMEthercatDirection[sync_index];
+		{ PARSE_SLAVE, "alias", FIELD_SLAVE_ALIAS, KIND_UINT, 0xffff },
+		{ PARSE_SLAVE, "position", FIELD_SLAVE_POSITION, KIND_UINT, 0xffff },
+		{ PARSE_SLAVE, "vendor_id", FIELD_SLAVE_VENDOR_ID, KIND_UINT, 0xffffffff },
+		{ PARSE_SLAVE, "product_code", FIELD_SLAVE_PRODUCT_CODE, KIND_UINT, 0xffffffff },
+		{ PARSE_SLAVE, "syncs", FIELD_SLAVE_SYNCS, KIND_ARRAY, 0 },
+		{ PARSE_SLAVE, "parameters", FIELD_SLAVE_PARAMETERS, KIND_ARRAY, 0 },
+		{ PARSE_SLAVE, "profile", FIELD_SLAVE_PROFILE, KIND_STRING, 0 },
+		{ PARSE_SLAVE, "revision", FIELD_SLAVE_REVISION, KIND_UINT, 0xffffffff },
 
-			if(m_syncs.HasMember("watchdog_enabled")){
-				assert(m_syncs["watchdog_enabled"].IsBool());
-				watchdog_enabled = (uint8_t) m_syncs["watchdog_enabled"].GetBool();
-			}
+		{ PARSE_SYNC, "index", FIELD_SYNC_INDEX, KIND_UINT, 0xff },
+		{ PARSE_SYNC, "watchdog_enabled", FIELD_SYNC_WATCHDOG_ENABLED, KIND_BOOL, 0 },
+		{ PARSE_SYNC, "direction", FIELD_SYNC_DIRECTION, KIND_STRING, 0 },
+		{ PARSE_SYNC, "pdos", FIELD_SYNC_PDOS, KIND_ARRAY, 0 },
 
-			// override default 'direction' value if it's defined
-			if(m_syncs.HasMember("direction")){
-				assert(m_syncs["direction"].IsString());
+		{ PARSE_PDO, "index", FIELD_PDO_INDEX, KIND_UINT, 0xffff },
+		{ PARSE_PDO, "entries", FIELD_PDO_ENTRIES, KIND_ARRAY, 0 },
+		{ PARSE_PDO, "remappable", FIELD_PDO_REMAPPABLE, KIND_BOOL, 0 },
 
-				std::string sync_direction = m_syncs["direction"].GetString();
+		{ PARSE_ENTRY, "index", FIELD_ENTRY_INDEX, KIND_UINT, 0xffff },
+		{ PARSE_ENTRY, "subindex", FIELD_ENTRY_SUBINDEX, KIND_UINT, 0xff },
+		{ PARSE_ENTRY, "size", FIELD_ENTRY_SIZE, KIND_UINT, 0xff },
+		{ PARSE_ENTRY, "add_to_domain", FIELD_ENTRY_ADD_TO_DOMAIN, KIND_BOOL, 0 },
+		{ PARSE_ENTRY, "swap_endian", FIELD_ENTRY_SWAP_ENDIAN, KIND_BOOL, 0 },
+		{ PARSE_ENTRY, "signed", FIELD_ENTRY_SIGNED, KIND_BOOL, 0 },
+		{ PARSE_ENTRY, "type", FIELD_ENTRY_TYPE, KIND_STRING, 0 },
+		{ PARSE_ENTRY, "scale", FIELD_ENTRY_SCALE, KIND_NUMBER, 0 },
+		{ PARSE_ENTRY, "offset", FIELD_ENTRY_OFFSET, KIND_NUMBER, 0 },
+		{ PARSE_ENTRY, "name", FIELD_ENTRY_NAME, KIND_STRING, 0 },
 
-				if(sync_direction == "input"){
-					direction = EC_DIR_INPUT;
-				} else if(sync_direction == "output"){
-					direction = EC_DIR_OUTPUT;
-				} else {
-					throw std::invalid_argument(
-						"\"" + sync_direction + "\" is invalid value. "
-						+ "'direction' value must be \"input\" or \"output\""
-					);
-				}
+		{ PARSE_PARAMETER, "index", FIELD_PARAMETER_INDEX, KIND_UINT, 0xffff },
+		{ PARSE_PARAMETER, "subindex", FIELD_PARAMETER_SUBINDEX, KIND_UINT, 0xff },
+		{ PARSE_PARAMETER, "size", FIELD_PARAMETER_SIZE, KIND_UINT, 0xff },
+		{ PARSE_PARAMETER, "value", FIELD_PARAMETER_VALUE, KIND_VALUE, 0 },
+		{ PARSE_PARAMETER, "type", FIELD_PARAMETER_TYPE, KIND_STRING, 0 },
+		{ PARSE_PARAMETER, "complete_access", FIELD_PARAMETER_COMPLETE_ACCESS, KIND_BOOL, 0 }
+	};
+
+#define field_bit(field) (1ULL << (field))
+
+/*****************************************************************************/
+
+// SAX handler of slave configuration. Slave entries and startup parameters
+// are emitted directly without building DOM. Slave and SM attributes may be
+// defined after their children, so they are patched into emitted entries
+// when their object ends.
+//
+// Root is either array of slaves, or object with 'slaves' and 'profiles'.
+// Profile holds syncs and parameters shared by identical slaves, it's parsed
+// once and expanded into each slave referencing it by end_document().
+class slaveConfigHandler
+	: public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, slaveConfigHandler>{
+public:
+	slaveConfigHandler(std::vector<slaveEntry> &slave_entries,
+		slave_size_et *slave_length, std::vector<startupConfig> &slave_parameters,
+		sparam_size_et *parameters_length, std::vector<uint8_t> &parameter_data,
+		std::vector<std::string> &entry_names, const esiCatalog *esi_catalog)
+		: entries(slave_entries), entries_length(slave_length),
+		parameters(slave_parameters), parameters_length(parameters_length),
+		data(parameter_data), names(entry_names), catalog(esi_catalog), state(PARSE_ROOT),
+		owner(PARSE_SLAVE), current(NULL), skip_depth(0), document_seen(0)
+	{
+	}
+
+	// expand profiles referenced by slaves, preserving document order
+	void end_document()
+	{
+		if(references.empty()){
+			return;
+		}
+
+		std::vector<slaveEntry> expanded_entries;
+		std::vector<startupConfig> expanded_parameters;
+		size_t next_entry = 0;
+		size_t next_parameter = 0;
+
+		for(const profileReference& ref : references){
+			auto found = profile_indexes.find(ref.profile);
+
+			if(found == profile_indexes.end()){
+				throw std::invalid_argument(
+					"Slave at position " + std::to_string(ref.position)
+					+ " references undefined profile \"" + ref.profile + "\""
+				);
 			}
 
-			rapidjson::Value::Array arr_pdos = m_syncs["pdos"].GetArray();
-			io_size_et size_arr_pdos = arr_pdos.Size();
-
-			for(io_size_et i_pdos = 0; i_pdos < size_arr_pdos; i_pdos++){
-				rapidjson::Value::Object m_pdos = arr_pdos[i_pdos].GetObject();
-				assert(m_pdos.HasMember("index"));
-
-				ecat_index_al pdo_index = _to_uint(m_pdos["index"]);
-
-				// add new slave entry if sync doesnt have pdo entries
-				if(!member_is_valid_array(m_pdos, "entries")){
-					(*slave_length)++;
-
-					slave_entries.push_back({
-							alias,
-							position,
-							vendor_id,
-							product_code,
-							sync_index,
-							pdo_index,
-							0,
-							0,
-							0,
-							0,
-							0,
-							0,
-							0,
-							direction,
-							0,
-							0,
-							0,
-							0
-						});
-
-					continue;
-				}
+			const parsedProfile& profile = profiles[found->second];
 
-				rapidjson::Value::Array arr_entries = m_pdos["entries"].GetArray();
-				int32_t size_arr_entries = arr_entries.Size();
-
-				for(io_size_et i_entries = 0; i_entries < size_arr_entries; i_entries++){
-					rapidjson::Value::Object m_entries = arr_entries[i_entries].GetObject();
-
-					assert(m_entries.HasMember("index"));
-					assert(m_entries.HasMember("subindex"));
-					assert(m_entries.HasMember("size"));
-
-					ecat_index_al entry_index;
-					ecat_sub_al entry_subindex;
-					ecat_size_al entry_size;
-
-					entry_index = _to_uint(m_entries["index"]);
-					entry_subindex = _to_uint(m_entries["subindex"]);
-					entry_size = _to_uint(m_entries["size"]);
-
-					uint8_t entry_add_to_domain = 0;
-					uint8_t entry_swap_endian = 0;
-					uint8_t entry_signed = 0;
-
-					if(m_entries.HasMember("swap_endian")){
-						assert(m_entries["swap_endian"].IsBool());
-						entry_swap_endian = (uint8_t) m_entries["swap_endian"].GetBool();
-					}
-
-					if(m_entries.HasMember("add_to_domain")){
-						assert(m_entries["add_to_domain"].IsBool());
-						entry_add_to_domain = (uint8_t) m_entries["add_to_domain"].GetBool();
-					}
-
-					if(m_entries.HasMember("signed")){
-						assert(m_entries["signed"].IsBool());
-						entry_signed = (uint8_t) m_entries["signed"].GetBool();
-					}
-
-					// add new slave entry
-					(*slave_length)++;
-
-					slave_entries.push_back({
-							alias,
-							position,
-							vendor_id,
-							product_code,
-							sync_index,
-							pdo_index,
-							entry_index,
-							entry_subindex,
-							entry_size,
-							entry_add_to_domain,
-							0,
-							0,
-							0,
-							direction,
-							entry_swap_endian,
-							entry_signed,
-							0,
-							watchdog_enabled
-						});
-				}
+			uint32_t vendor_id = profile_identity(ref, profile,
+				FIELD_SLAVE_VENDOR_ID, FIELD_PROFILE_VENDOR_ID, "vendor_id");
+			uint32_t product_code = profile_identity(ref, profile,
+				FIELD_SLAVE_PRODUCT_CODE, FIELD_PROFILE_PRODUCT_CODE, "product_code");
 
+			// slaves before this one are kept as they are
+			expanded_entries.insert(expanded_entries.end(),
+				entries.begin() + next_entry, entries.begin() + ref.entry_position);
+			expanded_parameters.insert(expanded_parameters.end(),
+				parameters.begin() + next_parameter,
+				parameters.begin() + ref.parameter_position);
+
+			next_entry = ref.entry_position;
+			next_parameter = ref.parameter_position;
+
+			for(slaveEntry profile_entry : profile.entries){
+				profile_entry.alias = ref.alias;
+				profile_entry.position = ref.position;
+				profile_entry.vendor_id = vendor_id;
+				profile_entry.product_code = product_code;
+
+				expanded_entries.push_back(profile_entry);
+			}
+
+			// add new slave entry if profile doesnt have syncs
+			if(profile.entries.empty()){
+				expanded_entries.push_back(empty_entry());
+				expanded_entries.back().alias = ref.alias;
+				expanded_entries.back().position = ref.position;
+				expanded_entries.back().vendor_id = vendor_id;
+				expanded_entries.back().product_code = product_code;
+			}
+
+			// profile parameters come before parameters of the slave itself
+			for(startupConfig profile_parameter : profile.parameters){
+				profile_parameter.slavePosition = ref.position;
+				expanded_parameters.push_back(profile_parameter);
 			}
+		}
+
+		expanded_entries.insert(expanded_entries.end(),
+			entries.begin() + next_entry, entries.end());
+		expanded_parameters.insert(expanded_parameters.end(),
+			parameters.begin() + next_parameter, parameters.end());
+
+		*entries_length += expanded_entries.size() - entries.size();
+		*parameters_length += expanded_parameters.size() - parameters.size();
+
+		entries.swap(expanded_entries);
+		parameters.swap(expanded_parameters);
+	}
+
+	bool Null()
+	{
+		if(skip_value()){
+			return true;
+		}
+
+		throw_invalid_kind();
+		return false;
+	}
+
+	bool Bool(bool value)
+	{
+		if(skip_value()){
+			return true;
+		}
+
+		expect_kind(KIND_BOOL);
+		store_bool(value);
+
+		return true;
+	}
+
+	bool Int(int value)
+	{
+		return Int64(value);
+	}
+
+	bool Uint(unsigned value)
+	{
+		return Uint64(value);
+	}
+
+	bool Int64(int64_t value)
+	{
+		if(skip_value()){
+			return true;
+		}
+
+		if(current == NULL){
+			throw_invalid_kind();
+		}
+
+		if(current->kind == KIND_NUMBER){
+			store_number(value);
+			return true;
+		}
+
+		if(current->kind == KIND_VALUE && value < 0){
+			parameter.value_kind = KIND_UINT;
+			parameter.value = (ecat_value_al) value;
+			parameter.is_negative = true;
+			return true;
+		}
+
+		if(value < 0){
+			throw std::invalid_argument(
+				"'" + std::string(current->name) + "' value must not be negative"
+			);
+		}
+
+		return Uint64(value);
+	}
+
+	bool Uint64(uint64_t value)
+	{
+		if(skip_value()){
+			return true;
+		}
+
+		if(current != NULL && current->kind == KIND_NUMBER){
+			store_number(value);
+			return true;
+		}
+
+		if(current != NULL && current->kind == KIND_VALUE){
+			parameter.value_kind = KIND_UINT;
+			parameter.value = value;
+			return true;
+		}
+
+		expect_kind(KIND_UINT);
+		store_uint(value);
+
+		return true;
+	}
 
+	bool Double(double value)
+	{
+		if(skip_value()){
+			return true;
 		}
 
-		// start adding startup parameters if there is one
-		if(member_is_valid_array(m_slaves, "parameters")){
-			assert(m_slaves["parameters"].IsArray());
+		if(current != NULL && current->kind == KIND_VALUE){
+			parameter.value_kind = KIND_NUMBER;
+			parameter.number = value;
+			return true;
+		}
+
+		expect_kind(KIND_NUMBER);
+		store_number(value);
+
+		return true;
+	}
+
+	bool String(const char *str, rapidjson::SizeType length, bool)
+	{
+		if(skip_value()){
+			return true;
+		}
+
+		if(current != NULL && current->kind == KIND_UINT){
+			store_uint(_to_uint(std::string(str, length), current->name));
+			return true;
+		}
+
+		if(current != NULL && current->kind == KIND_VALUE){
+			parameter.value_kind = KIND_STRING;
+			parameter.text.assign(str, length);
+			return true;
+		}
+
+		expect_kind(KIND_STRING);
+		store_string(std::string(str, length));
 
-			*parameters_length = m_slaves["parameters"].Size();
-			for(io_size_et i_parameters = 0; i_parameters < *parameters_length; i_parameters++){
-				rapidjson::Value::Object m_parameters = m_slaves["parameters"][i_parameters].GetObject();
-				assert(m_parameters.HasMember("index"));
-				assert(m_parameters.HasMember("subindex"));
-				assert(m_parameters.HasMember("size"));
-				assert(m_parameters.HasMember("value"));
+		return true;
+	}
+
+	bool Key(const char *str, rapidjson::SizeType, bool)
+	{
+		if(skip_depth > 0){
+			return true;
+		}
 
-				ecat_index_al p_index = _to_uint(m_parameters["index"]);
-				ecat_sub_al p_subindex = _to_uint(m_parameters["subindex"]);
-				ecat_size_al p_size = _to_uint(m_parameters["size"]);
-				uint32_t p_value = _to_uint(m_parameters["value"]);
+		// unknown member, its value will be skipped
+		current = NULL;
 
-				slave_parameters.push_back({
-						p_size,
-						(ecat_pos_al) position,
-						p_index,
-						p_subindex,
-						p_value
-					});
+		for(const parseField& field : parse_fields){
+			if(field.state == state && strcmp(field.name, str) == 0){
+				current = &field;
+				break;
 			}
 		}
 
+		if(current == NULL){
+			return true;
+		}
+
+		uint64_t *seen = seen_fields();
+
+		if(*seen & field_bit(current->field)){
+			throw std::invalid_argument(
+				"'" + std::string(current->name) + "' is defined more than once"
+			);
+		}
+
+		*seen |= field_bit(current->field);
+
+		return true;
 	}
 
-	// sort slave entries asc
-	if(do_sort_slave){
-#if DEBUG > 0
-	printf("Sorting slave entries...\n");
-#endif
-		std::sort(slave_entries.begin(), slave_entries.end(), _slave_entries_sort_asc);
+	bool StartObject()
+	{
+		if(skip_value()){
+			skip_depth++;
+			return true;
+		}
+
+		switch(state){
+			case PARSE_ROOT:
+				state = PARSE_DOCUMENT;
+				break;
+
+			case PARSE_PROFILES:
+				profile = parsedProfile();
+				profile.first_entry = entries.size();
+				profile.first_parameter = parameters.size();
+				state = PARSE_PROFILE;
+				break;
+
+			case PARSE_SLAVES:
+				slave = parsedSlave();
+				slave.first_entry = entries.size();
+				slave.first_parameter = parameters.size();
+				state = PARSE_SLAVE;
+				break;
+
+			case PARSE_SYNCS:
+				sync = parsedSync();
+				sync.first_entry = entries.size();
+				state = PARSE_SYNC;
+				break;
+
+			case PARSE_PDOS:
+				pdo = parsedPdo();
+				pdo.first_entry = entries.size();
+				state = PARSE_PDO;
+				break;
+
+			case PARSE_ENTRIES:
+				entry = parsedEntry();
+				state = PARSE_ENTRY;
+				break;
+
+			case PARSE_PARAMETERS:
+				parameter = parsedParameter();
+				state = PARSE_PARAMETER;
+				break;
+
+			default:
+				throw_invalid_kind();
+		}
+
+		current = NULL;
+
+		return true;
 	}
 
-#if DEBUG > 0
-	printf("slave_length = %d\n", *slave_length);
-#endif
+	bool EndObject(rapidjson::SizeType)
+	{
+		if(skip_depth > 0){
+			skip_depth--;
+			return true;
+		}
+
+		switch(state){
+			case PARSE_SLAVE:
+				end_slave();
+				state = PARSE_SLAVES;
+				break;
+
+			case PARSE_SYNC:
+				end_sync();
+				state = PARSE_SYNCS;
+				break;
+
+			case PARSE_PDO:
+				end_pdo();
+				state = PARSE_PDOS;
+				break;
+
+			case PARSE_ENTRY:
+				end_entry();
+				state = PARSE_ENTRIES;
+				break;
+
+			case PARSE_PARAMETER:
+				end_parameter();
+				state = PARSE_PARAMETERS;
+				break;
+
+			case PARSE_PROFILE:
+				end_profile();
+				state = PARSE_PROFILES;
+				break;
+
+			case PARSE_DOCUMENT:
+				require(document_seen, FIELD_DOCUMENT_SLAVES, "slaves");
+				state = PARSE_DONE;
+				break;
+		}
+
+		current = NULL;
+
+		return true;
+	}
+
+	bool StartArray()
+	{
+		if(skip_value()){
+			skip_depth++;
+			return true;
+		}
+
+		if(state == PARSE_ROOT){
+			state = PARSE_SLAVES;
+			return true;
+		}
+
+		expect_kind(KIND_ARRAY);
+
+		switch(current->field){
+			case FIELD_DOCUMENT_PROFILES:
+				state = PARSE_PROFILES;
+				break;
+
+			case FIELD_DOCUMENT_SLAVES:
+				state = PARSE_SLAVES;
+				break;
+
+			case FIELD_PROFILE_SYNCS:
+			case FIELD_SLAVE_SYNCS:
+				owner = state;
+				state = PARSE_SYNCS;
+				break;
+
+			case FIELD_PROFILE_PARAMETERS:
+			case FIELD_SLAVE_PARAMETERS:
+				owner = state;
+				state = PARSE_PARAMETERS;
+				break;
+
+			case FIELD_SYNC_PDOS:
+				state = PARSE_PDOS;
+				break;
+
+			case FIELD_PDO_ENTRIES:
+				state = PARSE_ENTRIES;
+				break;
+		}
+
+		current = NULL;
+
+		return true;
+	}
+
+	bool EndArray(rapidjson::SizeType)
+	{
+		if(skip_depth > 0){
+			skip_depth--;
+			return true;
+		}
+
+		switch(state){
+			case PARSE_SLAVES:
+				state = document_seen ? PARSE_DOCUMENT : PARSE_DONE;
+				break;
+
+			case PARSE_PROFILES:
+				state = PARSE_DOCUMENT;
+				break;
+
+			case PARSE_SYNCS:
+			case PARSE_PARAMETERS:
+				state = owner;
+				break;
+
+			case PARSE_PDOS:
+				state = PARSE_SYNC;
+				break;
+
+			case PARSE_ENTRIES:
+				state = PARSE_PDO;
+				break;
+		}
+
+		return true;
+	}
+
+private:
+	struct parsedProfile {
+		std::string name;
+		uint32_t vendor_id = 0;
+		uint32_t product_code = 0;
+
+		std::vector<slaveEntry> entries;
+		std::vector<startupConfig> parameters;
+
+		size_t first_entry = 0;
+		size_t first_parameter = 0;
+		uint64_t seen = 0;
+	};
+
+	// slave using profile, expanded at the end of document
+	struct profileReference {
+		std::string profile;
+
+		uint16_t alias;
+		ecat_pos_al position;
+		uint32_t vendor_id;
+		uint32_t product_code;
+		uint64_t seen;
+
+		size_t entry_position; /**< Where profile entries are inserted. */
+		size_t parameter_position; /**< Where profile parameters are inserted. */
+	};
+
+	struct parsedSlave {
+		uint16_t alias = 0;
+		ecat_pos_al position = 0;
+		uint32_t vendor_id = 0;
+		uint32_t product_code = 0;
+		uint32_t revision = 0;
+		std::string profile;
+
+		size_t first_entry = 0;
+		size_t first_parameter = 0;
+		uint64_t seen = 0;
+	};
+
+	struct parsedSync {
+		uint8_t index = 0;
+		uint8_t watchdog_enabled = 0;
+		std::string direction;
+
+		size_t first_entry = 0;
+		uint64_t seen = 0;
+	};
+
+	struct parsedPdo {
+		ecat_index_al index = 0;
+		uint8_t remappable = 0; /**< Entries may be reordered. */
+
+		size_t first_entry = 0;
+		uint64_t seen = 0;
+	};
+
+	struct parsedEntry {
+		ecat_index_al index = 0;
+		ecat_sub_al subindex = 0;
+		ecat_size_al size = 0;
+
+		uint8_t add_to_domain = 0;
+		uint8_t swap_endian = 0;
+		uint8_t is_signed = 0;
+
+		std::string type;
+		double scale = 1;
+		double scale_offset = 0;
+		std::string name;
+
+		uint64_t seen = 0;
+	};
+
+	struct parsedParameter {
+		ecat_index_al index = 0;
+		ecat_sub_al subindex = 0;
+		ecat_size_al size = 0;
+		std::string type;
+		uint8_t complete_access = 0;
+
+		// value as it's given, converted by type when parameter ends
+		uint8_t value_kind = KIND_UINT; /**< KIND_UINT, KIND_NUMBER or KIND_STRING. */
+		ecat_value_al value = 0; /**< Integer value, two's complement if negative. */
+		bool is_negative = false;
+		double number = 0;
+		std::string text;
+
+		uint64_t seen = 0;
+	};
+
+	std::vector<slaveEntry> &entries;
+	slave_size_et *entries_length;
+	std::vector<startupConfig> &parameters;
+	sparam_size_et *parameters_length;
+	std::vector<uint8_t> &data; /**< Values of string and octets parameters. */
+	std::vector<std::string> &names;
+	const esiCatalog *catalog; /**< NULL if slaves are not resolved from ESI. */
+
+	uint8_t state;
+	uint8_t owner; /**< Object of current syncs or parameters. */
+	const parseField *current; /**< Member of current value, NULL if unknown. */
+	uint32_t skip_depth; /**< Nesting level inside skipped value. */
+	uint64_t document_seen; /**< Members of root object. */
+
+	parsedSlave slave;
+	parsedSync sync;
+	parsedPdo pdo;
+	parsedEntry entry;
+	parsedParameter parameter;
+	parsedProfile profile;
+
+	std::vector<parsedProfile> profiles;
+	std::map<std::string, size_t> profile_indexes;
+	std::vector<profileReference> references;
+
+	// names must be unique across all entries
+	std::set<std::string> used_names;
+
+	// value of unknown member is skipped, including nested object or array
+	bool skip_value()
+	{
+		if(skip_depth > 0){
+			return true;
+		}
+
+		bool in_object = state == PARSE_SLAVE || state == PARSE_SYNC
+						|| state == PARSE_PDO || state == PARSE_ENTRY
+						|| state == PARSE_PARAMETER || state == PARSE_DOCUMENT
+						|| state == PARSE_PROFILE;
+
+		return in_object && current == NULL;
+	}
+
+	uint64_t* seen_fields()
+	{
+		switch(state){
+			case PARSE_SLAVE: return &slave.seen;
+			case PARSE_SYNC: return &sync.seen;
+			case PARSE_PDO: return &pdo.seen;
+			case PARSE_ENTRY: return &entry.seen;
+			case PARSE_DOCUMENT: return &document_seen;
+			case PARSE_PROFILE: return &profile.seen;
+			default: return &parameter.seen;
+		}
+	}
+
+	void throw_invalid_kind()
+	{
+		static const char *kind_names[] = {
+				"an integer or hexadecimal string",
+				"a boolean",
+				"a string",
+				"a number",
+				"an array",
+				"an integer, number or string"
+			};
+
+		if(state == PARSE_ROOT){
+			throw std::invalid_argument("Slave configuration must be an array or an object");
+		}
+
+		if(current == NULL){
+			throw std::invalid_argument("Unexpected value, expected an object");
+		}
+
+		throw std::invalid_argument(
+			"'" + std::string(current->name) + "' value must be "
+			+ kind_names[current->kind]
+		);
+	}
+
+	void expect_kind(uint8_t kind)
+	{
+		if(current == NULL || current->kind != kind){
+			throw_invalid_kind();
+		}
+	}
+
+	void require(uint64_t seen, uint8_t field, const char *name)
+	{
+		if(!(seen & field_bit(field))){
+			throw std::invalid_argument("'" + std::string(name) + "' is required");
+		}
+	}
+
+	void store_uint(uint64_t value)
+	{
+		if(value > current->max){
+			throw std::invalid_argument(
+				"\"" + std::to_string(value) + "\" is out of range. "
+				+ "'" + current->name + "' value must not be greater than "
+				+ std::to_string(current->max)
+			);
+		}
+
+		switch(current->field){
+			case FIELD_SLAVE_ALIAS: slave.alias = value; break;
+			case FIELD_SLAVE_POSITION: slave.position = value; break;
+			case FIELD_SLAVE_VENDOR_ID: slave.vendor_id = value; break;
+			case FIELD_SLAVE_PRODUCT_CODE: slave.product_code = value; break;
+			case FIELD_SLAVE_REVISION: slave.revision = value; break;
+			case FIELD_PROFILE_VENDOR_ID: profile.vendor_id = value; break;
+			case FIELD_PROFILE_PRODUCT_CODE: profile.product_code = value; break;
+			case FIELD_SYNC_INDEX: sync.index = value; break;
+			case FIELD_PDO_INDEX: pdo.index = value; break;
+			case FIELD_ENTRY_INDEX: entry.index = value; break;
+			case FIELD_ENTRY_SUBINDEX: entry.subindex = value; break;
+			case FIELD_ENTRY_SIZE: entry.size = value; break;
+			case FIELD_PARAMETER_INDEX: parameter.index = value; break;
+			case FIELD_PARAMETER_SUBINDEX: parameter.subindex = value; break;
+			case FIELD_PARAMETER_SIZE: parameter.size = value; break;
+		}
+	}
+
+	void store_bool(bool value)
+	{
+		switch(current->field){
+			case FIELD_SYNC_WATCHDOG_ENABLED: sync.watchdog_enabled = value; break;
+			case FIELD_PDO_REMAPPABLE: pdo.remappable = value; break;
+			case FIELD_ENTRY_ADD_TO_DOMAIN: entry.add_to_domain = value; break;
+			case FIELD_ENTRY_SWAP_ENDIAN: entry.swap_endian = value; break;
+			case FIELD_ENTRY_SIGNED: entry.is_signed = value; break;
+			case FIELD_PARAMETER_COMPLETE_ACCESS: parameter.complete_access = value; break;
+		}
+	}
+
+	void store_string(const std::string& value)
+	{
+		switch(current->field){
+			case FIELD_SYNC_DIRECTION: sync.direction = value; break;
+			case FIELD_ENTRY_TYPE: entry.type = value; break;
+			case FIELD_ENTRY_NAME: entry.name = value; break;
+			case FIELD_SLAVE_PROFILE: slave.profile = value; break;
+			case FIELD_PROFILE_NAME: profile.name = value; break;
+			case FIELD_PARAMETER_TYPE: parameter.type = value; break;
+		}
+	}
+
+	void store_number(double value)
+	{
+		switch(current->field){
+			case FIELD_ENTRY_SCALE: entry.scale = value; break;
+			case FIELD_ENTRY_OFFSET: entry.scale_offset = value; break;
+		}
+	}
+
+	void end_entry()
+	{
+		require(entry.seen, FIELD_ENTRY_INDEX, "index");
+		require(entry.seen, FIELD_ENTRY_SUBINDEX, "subindex");
+		require(entry.seen, FIELD_ENTRY_SIZE, "size");
+
+		uint8_t entry_type = _to_entry_type(
+				entry.seen & field_bit(FIELD_ENTRY_TYPE) ? &entry.type : NULL,
+				entry.size,
+				entry.is_signed
+			);
+
+		if(entry.scale == 0){
+			throw std::invalid_argument("'scale' value must not be 0");
+		}
+
+		// bytes of other multibyte sizes aren't swapped by process data
+		// kernels, swapping a single byte or bit has no effect
+		if(entry.swap_endian && entry.size > 8
+			&& entry.size != 16 && entry.size != 32 && entry.size != 64
+		){
+			throw std::invalid_argument(
+				"'swap_endian' is only allowed for 16, 32 and 64 bits entries"
+			);
+		}
+
+		uint32_t entry_name_id = ENTRY_NAME_NONE;
+
+		if(entry.seen & field_bit(FIELD_ENTRY_NAME)){
+			// profile entries are shared by several slaves
+			if(owner == PARSE_PROFILE){
+				throw std::invalid_argument("'name' must not be defined inside profile");
+			}
+
+			if(entry.name.empty()){
+				throw std::invalid_argument("'name' value must not be empty");
+			}
+
+			if(!used_names.insert(entry.name).second){
+				throw std::invalid_argument(
+					"\"" + entry.name + "\" is duplicated. "
+					+ "'name' value must be unique"
+				);
+			}
+
+			entry_name_id = names.size();
+			names.push_back(entry.name);
+		}
+
+		// add new slave entry, slave, SM and PDO attributes are patched later
+		(*entries_length)++;
+
+		entries.push_back({
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				entry.index,
+				entry.subindex,
+				entry.size,
+				entry.add_to_domain,
+				0,
+				0,
+				0,
+				0,
+				entry.swap_endian,
+				(uint8_t) (entry_type == ECAT_TYPE_INT),
+				0,
+				0,
+				entry_type,
+				entry.scale,
+				entry.scale_offset,
+				entry_name_id
+			});
+	}
+
+	void end_pdo()
+	{
+		require(pdo.seen, FIELD_PDO_INDEX, "index");
+
+		// add new slave entry if pdo doesnt have entries
+		if(entries.size() == pdo.first_entry){
+			(*entries_length)++;
+
+			entries.push_back({
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					0,
+					1,
+					0,
+					ENTRY_NAME_NONE
+				});
+		}
+
+		for(size_t i_entry = pdo.first_entry; i_entry < entries.size(); i_entry++){
+			entries[i_entry].pdo_index = pdo.index;
+		}
+
+		// widest entries first, so they are aligned to their size from PDO
+		// start. Bits and gaps keep their order after them
+		if(pdo.remappable){
+			std::stable_sort(entries.begin() + pdo.first_entry, entries.end(),
+				[](const slaveEntry& e1, const slaveEntry& e2){
+					return _entry_alignment(e1) > _entry_alignment(e2);
+				});
+
+			align_pdo();
+		}
+	}
+
+	// Earlier PDOs of the SM may end unaligned, then remappable PDO starts with
+	// a gap up to alignment of its widest entry. Its entries are aligned from
+	// start of SM's process data then.
+	void align_pdo()
+	{
+		uint32_t offset = 0;
+		for(size_t i_entry = sync.first_entry; i_entry < pdo.first_entry; i_entry++){
+			offset += entries[i_entry].size;
+		}
+
+		uint8_t alignment = _entry_alignment(entries[pdo.first_entry]);
+
+		if(alignment == 0 || offset % alignment == 0){
+			return;
+		}
+
+		slaveEntry gap = entries[pdo.first_entry];
+		gap.index = 0;
+		gap.subindex = 0;
+		gap.size = alignment - offset % alignment;
+		gap.add_to_domain = 0;
+		gap.SWAP_ENDIAN = 0;
+		gap.SIGNED = 0;
+		gap.type = _to_entry_type(NULL, gap.size, 0);
+		gap.scale = 1;
+		gap.scale_offset = 0;
+		gap.name_id = ENTRY_NAME_NONE;
+
+		(*entries_length)++;
+		entries.insert(entries.begin() + pdo.first_entry, gap);
+	}
+
+	void end_sync()
+	{
+		require(sync.seen, FIELD_SYNC_INDEX, "index");
+		require(sync.seen, FIELD_SYNC_PDOS, "pdos");
+
+		uint8_t direction;
+
+		// override default 'direction' value if it's defined
+		if(sync.seen & field_bit(FIELD_SYNC_DIRECTION)){
+			if(sync.direction == "input"){
+				direction = EC_DIR_INPUT;
+			} else if(sync.direction == "output"){
+				direction = EC_DIR_OUTPUT;
+			} else {
+				throw std::invalid_argument(
+					"\"" + sync.direction + "\" is invalid value. "
+					+ "'direction' value must be \"input\" or \"output\""
+				);
+			}
+		} else if(sync.index < sizeof(SyncMEthercatDirection)){
+			direction = SyncMEthercatDirection[sync.index];
+		} else {
+			throw std::invalid_argument(
+				"'direction' is required for SM index "
+				+ std::to_string(sync.index)
+			);
+		}
+
+		for(size_t i_entry = sync.first_entry; i_entry < entries.size(); i_entry++){
+			entries[i_entry].sync_index = sync.index;
+			entries[i_entry].direction = direction;
+			entries[i_entry].WATCHDOG_ENABLED = sync.watchdog_enabled;
+		}
+	}
+
+	void end_parameter()
+	{
+		require(parameter.seen, FIELD_PARAMETER_INDEX, "index");
+		require(parameter.seen, FIELD_PARAMETER_SUBINDEX, "subindex");
+		require(parameter.seen, FIELD_PARAMETER_VALUE, "value");
+
+		bool has_size = parameter.seen & field_bit(FIELD_PARAMETER_SIZE);
+		uint8_t type = _to_parameter_type(
+				parameter.seen & field_bit(FIELD_PARAMETER_TYPE) ? &parameter.type : NULL
+			);
+
+		startupConfig config = {
+				parameter.size,
+				0,
+				parameter.index,
+				parameter.subindex,
+				0,
+				type,
+				parameter.complete_access,
+				PARAM_DATA_NONE,
+				0
+			};
+
+		switch(type){
+			case PARAM_TYPE_UINT:
+			case PARAM_TYPE_INT:
+				require(parameter.seen, FIELD_PARAMETER_SIZE, "size");
+				config.value = parameter_integer(type == PARAM_TYPE_INT);
+				break;
+
+			case PARAM_TYPE_REAL32:
+			case PARAM_TYPE_REAL64:
+				config.size = type == PARAM_TYPE_REAL32 ? 32 : 64;
+
+				if(has_size && parameter.size != config.size){
+					throw std::invalid_argument(
+						std::string(type == PARAM_TYPE_REAL32 ? "'real32'" : "'real64'")
+						+ " parameter size must be " + std::to_string(config.size)
+					);
+				}
+
+				config.value = parameter_real(type);
+				break;
+
+			default:
+				// length of string and octets is taken from value
+				if(has_size){
+					throw std::invalid_argument(
+						"'size' must not be defined for string or octets parameter"
+					);
+				}
+
+				config.size = 0;
+				store_parameter_data(type, config);
+				break;
+		}
+
+		// complete access starts from subindex 0, including it
+		if(config.complete_access && config.subindex != 0){
+			throw std::invalid_argument("'subindex' must be 0 for complete access");
+		}
+
+		(*parameters_length)++;
+
+		parameters.push_back(config);
+	}
+
+	ecat_value_al parameter_integer(bool is_signed)
+	{
+		if(parameter.size != 8 && parameter.size != 16
+			&& parameter.size != 32 && parameter.size != 64
+		){
+			throw std::invalid_argument(
+				"\"" + std::to_string(parameter.size) + "\" is invalid parameter size. "
+				+ "'size' value must be 8, 16, 32 or 64"
+			);
+		}
+
+		if(parameter.value_kind == KIND_NUMBER){
+			throw std::invalid_argument(
+				"'value' value must be an integer or hexadecimal string"
+			);
+		}
+
+		// hexadecimal string is raw value, also for signed type
+		if(parameter.value_kind == KIND_STRING){
+			parameter.value = _to_uint(parameter.text, "value");
+			parameter.is_negative = false;
+		}
+
+		if(parameter.is_negative && !is_signed){
+			throw std::invalid_argument("'value' value must not be negative");
+		}
+
+		bool is_in_range = parameter.is_negative
+			? parameter.size == 64
+				|| (int64_t) parameter.value >= -(int64_t) (1ULL << (parameter.size - 1))
+			: parameter.value <= mask(parameter.size);
+
+		if(!is_in_range){
+			throw std::invalid_argument(
+				"'value' value is out of range of "
+				+ std::to_string(parameter.size) + " bits parameter"
+			);
+		}
+
+		return parameter.value & mask(parameter.size);
+	}
+
+	ecat_value_al parameter_real(uint8_t type)
+	{
+		double number;
+
+		switch(parameter.value_kind){
+			case KIND_NUMBER: number = parameter.number; break;
+			case KIND_UINT:
+				number = parameter.is_negative
+					? (double) (int64_t) parameter.value
+					: (double) parameter.value;
+				break;
+			default:
+				throw std::invalid_argument("'value' value must be a number");
+		}
+
+		// value holds bits of the real, like process data does
+		if(type == PARAM_TYPE_REAL32){
+			float real = (float) number;
+			uint32_t bits;
+			memcpy(&bits, &real, sizeof(bits));
+
+			return bits;
+		}
+
+		uint64_t bits;
+		memcpy(&bits, &number, sizeof(bits));
+
+		return bits;
+	}
+
+	void store_parameter_data(uint8_t type, startupConfig &config)
+	{
+		if(parameter.value_kind != KIND_STRING){
+			throw std::invalid_argument(
+				type == PARAM_TYPE_STRING
+				? "'value' value must be a string"
+				: "'value' value must be a hexadecimal string"
+			);
+		}
+
+		std::string bytes;
+
+		if(type == PARAM_TYPE_STRING){
+			bytes = parameter.text;
+		} else {
+			std::string hex = parameter.text;
+
+			// strip '0x' prefix, separators between octets are ignored
+			if(hex.size() > 1 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')){
+				hex = hex.substr(2);
+			}
+
+			hex = normalize_hex_string(hex);
+
+			if(hex.size() % 2){
+				throw std::invalid_argument(
+					"\"" + parameter.text + "\" is invalid value. "
+					+ "'value' value must have two hexadecimal digits per octet"
+				);
+			}
+
+			for(size_t i_digit = 0; i_digit < hex.size(); i_digit += 2){
+				bytes += (char) strtoul(hex.substr(i_digit, 2).c_str(), NULL, 16);
+			}
+		}
+
+		if(bytes.empty()){
+			throw std::invalid_argument("'value' value must not be empty");
+		}
+
+		config.data_offset = data.size();
+		config.data_length = bytes.size();
+
+		data.insert(data.end(), bytes.begin(), bytes.end());
+	}
+
+	void end_profile()
+	{
+		require(profile.seen, FIELD_PROFILE_NAME, "name");
+
+		if(profile_indexes.count(profile.name)){
+			throw std::invalid_argument(
+				"Duplicate profile name \"" + profile.name + "\""
+			);
+		}
+
+		// profile entries are kept aside, slaves get their own copy
+		profile.entries.assign(entries.begin() + profile.first_entry, entries.end());
+		profile.parameters.assign(parameters.begin() + profile.first_parameter,
+			parameters.end());
+
+		*entries_length -= profile.entries.size();
+		*parameters_length -= profile.parameters.size();
+
+		entries.erase(entries.begin() + profile.first_entry, entries.end());
+		parameters.erase(parameters.begin() + profile.first_parameter, parameters.end());
+
+		profile_indexes[profile.name] = profiles.size();
+		profiles.push_back(profile);
+	}
+
+	void end_slave()
+	{
+		require(slave.seen, FIELD_SLAVE_ALIAS, "alias");
+		require(slave.seen, FIELD_SLAVE_POSITION, "position");
+
+		for(size_t i_param = slave.first_parameter; i_param < parameters.size(); i_param++){
+			parameters[i_param].slavePosition = slave.position;
+		}
+
+		if(slave.seen & field_bit(FIELD_SLAVE_PROFILE)){
+			if(slave.seen & field_bit(FIELD_SLAVE_SYNCS)){
+				throw std::invalid_argument("'syncs' must not be defined together with 'profile'");
+			}
+
+			references.push_back({
+					slave.profile,
+					slave.alias,
+					slave.position,
+					slave.vendor_id,
+					slave.product_code,
+					slave.seen,
+					entries.size(),
+					slave.first_parameter
+				});
+
+			return;
+		}
+
+		require(slave.seen, FIELD_SLAVE_VENDOR_ID, "vendor_id");
+		require(slave.seen, FIELD_SLAVE_PRODUCT_CODE, "product_code");
+
+		// slave defined by identity only, use default PDOs from ESI
+		if(catalog != NULL && !(slave.seen & field_bit(FIELD_SLAVE_SYNCS))){
+			add_esi_entries();
+		}
+
+		// add new slave entry if slave doesnt have syncs
+		if(entries.size() == slave.first_entry){
+			(*entries_length)++;
+			entries.push_back(empty_entry());
+		}
+
+		for(size_t i_entry = slave.first_entry; i_entry < entries.size(); i_entry++){
+			entries[i_entry].alias = slave.alias;
+			entries[i_entry].position = slave.position;
+			entries[i_entry].vendor_id = slave.vendor_id;
+			entries[i_entry].product_code = slave.product_code;
+		}
+	}
+
+	void add_esi_entries()
+	{
+		const esiDevice *device = find_esi_device(*catalog, slave.vendor_id,
+			slave.product_code, slave.revision,
+			slave.seen & field_bit(FIELD_SLAVE_REVISION));
+
+		// wrong identity or missing ESI file would leave slave without process
+		// data. Devices without process data, e.g. couplers, are in their
+		// vendor's ESI files too, or are defined with empty 'syncs'.
+		if(device == NULL){
+			char identity[96];
+			int length = snprintf(identity, sizeof(identity),
+				"vendor_id 0x%08x, product_code 0x%08x",
+				slave.vendor_id, slave.product_code);
+
+			if(slave.seen & field_bit(FIELD_SLAVE_REVISION)){
+				snprintf(identity + length, sizeof(identity) - length,
+					", revision 0x%08x", slave.revision);
+			}
+
+			throw std::invalid_argument(
+				"Slave at position " + std::to_string(slave.position)
+				+ " (" + identity + ") is not found in ESI files"
+			);
+		}
+
+		if(!device->unsupported.empty()){
+			throw std::invalid_argument(
+				"PDOs of ESI device " + device->type + " can't be used, "
+				+ device->unsupported + ". 'syncs' must be defined"
+			);
+		}
+
+		*entries_length += device->entries.size();
+		entries.insert(entries.end(), device->entries.begin(), device->entries.end());
+	}
+
+	// identity of slave using profile, slave may only repeat the profile value
+	uint32_t profile_identity(const profileReference &ref, const parsedProfile &profile,
+		uint8_t slave_field, uint8_t profile_field, const char *name)
+	{
+		bool in_slave = ref.seen & field_bit(slave_field);
+		bool in_profile = profile.seen & field_bit(profile_field);
+		uint32_t slave_value = slave_field == FIELD_SLAVE_VENDOR_ID
+								? ref.vendor_id : ref.product_code;
+		uint32_t profile_value = profile_field == FIELD_PROFILE_VENDOR_ID
+								? profile.vendor_id : profile.product_code;
+
+		if(!in_slave && !in_profile){
+			throw std::invalid_argument(
+				std::string("'") + name + "' is not defined for slave at position "
+				+ std::to_string(ref.position)
+			);
+		}
+
+		if(in_slave && in_profile && slave_value != profile_value){
+			throw std::invalid_argument(
+				std::string("'") + name + "' of slave at position "
+				+ std::to_string(ref.position) + " differs from profile \""
+				+ profile.name + "\""
+			);
+		}
+
+		return in_slave ? slave_value : profile_value;
+	}
+
+	static slaveEntry empty_entry()
+	{
+		return {
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				0,
+				1,
+				0,
+				ENTRY_NAME_NONE
+			};
+	}
+};
+
+/*****************************************************************************/
+
+// JSON text source, reports errors by line and column
+template <typename Stream>
+class jsonTextSource {
+public:
+	explicit jsonTextSource(Stream &text_stream) : stream(text_stream)
+	{
+	}
+
+	template <typename Handler>
+	bool parse(Handler &handler)
+	{
+		result = reader.Parse(stream, handler);
+
+		return !result.IsError();
+	}
+
+	std::string error() const
+	{
+		return rapidjson::GetParseError_En(result.Code());
+	}
+
+	std::string location() const
+	{
+		return "line " + std::to_string(stream.GetLine())
+			+ ", column " + std::to_string(stream.GetColumn());
+	}
+
+private:
+	rapidjson::CursorStreamWrapper<Stream> stream;
+	rapidjson::Reader reader;
+	rapidjson::ParseResult result;
+};
+
+// forwards events of configEventSource into rapidjson handler
+template <typename Handler>
+class configEventForwarder : public configEventSink {
+public:
+	explicit configEventForwarder(Handler &event_handler) : handler(event_handler)
+	{
+	}
+
+	bool Null() override { return handler.Null(); }
+	bool Bool(bool value) override { return handler.Bool(value); }
+	bool Int64(int64_t value) override { return handler.Int64(value); }
+	bool Uint64(uint64_t value) override { return handler.Uint64(value); }
+	bool Double(double value) override { return handler.Double(value); }
+
+	bool String(const char *str, size_t length) override
+	{
+		return handler.String(str, length, true);
+	}
+
+	bool Key(const char *str, size_t length) override
+	{
+		return handler.Key(str, length, true);
+	}
+
+	bool StartObject() override { return handler.StartObject(); }
+	bool EndObject(size_t member_count) override { return handler.EndObject(member_count); }
+	bool StartArray() override { return handler.StartArray(); }
+	bool EndArray(size_t element_count) override { return handler.EndArray(element_count); }
+
+private:
+	Handler &handler;
+};
+
+// configEventSource adapter, reports errors by its own location
+class eventSource {
+public:
+	explicit eventSource(configEventSource &event_source) : source(event_source)
+	{
+	}
+
+	template <typename Handler>
+	bool parse(Handler &handler)
+	{
+		configEventForwarder<Handler> forwarder(handler);
+
+		return source.emit(forwarder);
+	}
+
+	std::string error() const
+	{
+		return "Invalid slave configuration";
+	}
+
+	std::string location() const
+	{
+		return source.location();
+	}
+
+private:
+	configEventSource &source;
+};
+
+template <typename Source>
+static int8_t _parse_config(Source &source, std::vector<slaveEntry> &slave_entries,
+	slave_size_et *slave_length, std::vector<startupConfig> &slave_parameters,
+	sparam_size_et *parameters_length, std::vector<uint8_t> &parameter_data,
+	std::vector<std::string> &entry_names, const char *schema_string,
+	bool do_sort_slave, const esiCatalog *esi_catalog)
+{
+	*slave_length = 0;
+	*parameters_length = 0;
+
+	size_t entries_size = slave_entries.size();
+	size_t parameters_size = slave_parameters.size();
+	size_t data_size = parameter_data.size();
+	size_t names_size = entry_names.size();
+
+	slaveConfigHandler handler(slave_entries, slave_length, slave_parameters,
+		parameters_length, parameter_data, entry_names, esi_catalog);
+
+	bool is_parsed;
+
+	try {
+		if(schema_string != NULL){
+			rapidjson::Document schema_json;
+			schema_json.Parse(schema_string);
+
+			if(schema_json.HasParseError()){
+				throw std::invalid_argument(
+					std::string("Invalid slave configuration schema, ")
+					+ rapidjson::GetParseError_En(schema_json.GetParseError())
+				);
+			}
+
+			// validate while parsing, handler only receives valid values
+			rapidjson::SchemaDocument schema(schema_json);
+			rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument,
+				slaveConfigHandler> validator(schema, handler);
+
+			is_parsed = source.parse(validator);
+
+			if(!is_parsed && !validator.IsValid()){
+				rapidjson::StringBuffer pointer;
+				validator.GetInvalidDocumentPointer().StringifyUriFragment(pointer);
+
+				throw std::invalid_argument(
+					std::string("'") + pointer.GetString()
+					+ "' does not match schema keyword '"
+					+ validator.GetInvalidSchemaKeyword() + "'"
+				);
+			}
+		} else {
+			is_parsed = source.parse(handler);
+		}
+
+		if(!is_parsed){
+			throw std::invalid_argument(source.error());
+		}
+
+		handler.end_document();
+	} catch (const std::exception& err) {
+		// discard partially parsed configuration
+		slave_entries.resize(entries_size);
+		slave_parameters.resize(parameters_size);
+		parameter_data.resize(data_size);
+		entry_names.resize(names_size);
+		*slave_length = 0;
+		*parameters_length = 0;
+
+		throw std::invalid_argument(
+			"Slave configuration error at " + source.location() + ": " + err.what()
+		);
+	}
+
+	// sort slave entries asc, result doesn't depend on sort implementation
+	if(do_sort_slave){
+#if DEBUG > 0
+	printf("Sorting slave entries...\n");
+#endif
+		std::stable_sort(slave_entries.begin(), slave_entries.end(),
+			_slave_entries_layout_asc);
+	}
+
+#if DEBUG > 0
+	printf("slave_length = %d\n", *slave_length);
+#endif
+
+	return 0;
+}
+
+int8_t parse_json(const char *json_string, std::vector<slaveEntry> &slave_entries,
+	slave_size_et *slave_length, std::vector<startupConfig> &slave_parameters,
+	sparam_size_et *parameters_length, std::vector<uint8_t> &parameter_data,
+	std::vector<std::string> &entry_names, const char *schema_string,
+	bool do_sort_slave, const esiCatalog *esi_catalog)
+{
+	rapidjson::StringStream stream(json_string);
+	jsonTextSource<rapidjson::StringStream> source(stream);
+
+	return _parse_config(source, slave_entries, slave_length, slave_parameters,
+		parameters_length, parameter_data, entry_names, schema_string,
+		do_sort_slave, esi_catalog);
+}
+
+int8_t parse_json_buffer(const char *json, size_t length,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names,
+	const char *schema_string, bool do_sort_slave, const esiCatalog *esi_catalog)
+{
+	// buffer doesn't need to be NUL terminated and is never copied
+	rapidjson::MemoryStream stream(json, length);
+	jsonTextSource<rapidjson::MemoryStream> source(stream);
+
+	return _parse_config(source, slave_entries, slave_length, slave_parameters,
+		parameters_length, parameter_data, entry_names, schema_string,
+		do_sort_slave, esi_catalog);
+}
+
+int8_t parse_config_events(configEventSource &event_source,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names,
+	const char *schema_string, bool do_sort_slave, const esiCatalog *esi_catalog)
+{
+	eventSource source(event_source);
+
+	return _parse_config(source, slave_entries, slave_length, slave_parameters,
+		parameters_length, parameter_data, entry_names, schema_string,
+		do_sort_slave, esi_catalog);
+}
+
+/*****************************************************************************/
+
+// Binary cache of parsed slave configuration. Layout:
+// header | slave entries | startup parameters | parameter data |
+// NUL terminated entry names
+#define CONFIG_CACHE_MAGIC "ECATCFG"
+#define CONFIG_CACHE_VERSION 5
+
+typedef struct configCacheHeader_s{
+	char magic[8];
+	uint32_t version;
+	uint32_t entry_size; /**< sizeof(slaveEntry) of the writer. */
+	uint32_t parameter_size; /**< sizeof(startupConfig) of the writer. */
+	uint32_t entries_length;
+	uint32_t parameters_length;
+	uint32_t names_length;
+	uint64_t data_bytes;
+	uint64_t names_bytes;
+	uint64_t source_hash; /**< Hash of JSON source and parse options. */
+	uint64_t checksum; /**< Hash of everything after header. */
+} configCacheHeader;
+
+uint64_t fnv1a(const void *data, size_t length, uint64_t hash)
+{
+	const uint8_t *bytes = (const uint8_t *) data;
+
+	for(size_t i_byte = 0; i_byte < length; i_byte++){
+		hash ^= bytes[i_byte];
+		hash *= FNV1A_PRIME;
+	}
+
+	return hash;
+}
+
+uint64_t config_source_hash(const char *json, size_t length,
+	const char *schema_string, bool do_sort_slave, uint64_t esi_stamp)
+{
+	// configuration compiled without validation isn't used if schema is given
+	uint8_t options = do_sort_slave | (schema_string != NULL) << 1;
+	uint64_t hash = fnv1a(json, length);
+
+	hash = fnv1a(&options, sizeof(options), hash);
+
+	if(schema_string != NULL){
+		hash = fnv1a(schema_string, strlen(schema_string), hash);
+	}
+
+	return esi_stamp ? fnv1a(&esi_stamp, sizeof(esi_stamp), hash) : hash;
+}
+
+int8_t save_config_cache(const char *cache_path, uint64_t source_hash,
+	const std::vector<slaveEntry> &slave_entries,
+	const std::vector<startupConfig> &slave_parameters,
+	const std::vector<uint8_t> &parameter_data,
+	const std::vector<std::string> &entry_names)
+{
+	std::string names;
+	for(const std::string& name : entry_names){
+		names.append(name.c_str(), name.size() + 1);
+	}
+
+	configCacheHeader header = {};
+	memcpy(header.magic, CONFIG_CACHE_MAGIC, sizeof(CONFIG_CACHE_MAGIC));
+	header.version = CONFIG_CACHE_VERSION;
+	header.entry_size = sizeof(slaveEntry);
+	header.parameter_size = sizeof(startupConfig);
+	header.entries_length = slave_entries.size();
+	header.parameters_length = slave_parameters.size();
+	header.names_length = entry_names.size();
+	header.data_bytes = parameter_data.size();
+	header.names_bytes = names.size();
+	header.source_hash = source_hash;
+
+	size_t entries_bytes = slave_entries.size() * sizeof(slaveEntry);
+	size_t parameters_bytes = slave_parameters.size() * sizeof(startupConfig);
+
+	header.checksum = fnv1a(slave_entries.data(), entries_bytes);
+	header.checksum = fnv1a(slave_parameters.data(), parameters_bytes, header.checksum);
+	header.checksum = fnv1a(parameter_data.data(), parameter_data.size(), header.checksum);
+	header.checksum = fnv1a(names.data(), names.size(), header.checksum);
+
+	// write into temporary file first, so cache is never half written
+	std::string tmp_path = std::string(cache_path) + ".tmp";
+	FILE *file = fopen(tmp_path.c_str(), "wb");
+
+	if(file == NULL){
+		return -1;
+	}
+
+	bool is_written = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(slave_entries.data(), 1, entries_bytes, file) == entries_bytes
+			&& fwrite(slave_parameters.data(), 1, parameters_bytes, file) == parameters_bytes
+			&& fwrite(parameter_data.data(), 1, parameter_data.size(), file)
+				== parameter_data.size()
+			&& fwrite(names.data(), 1, names.size(), file) == names.size();
+
+	if(fclose(file) != 0 || !is_written || rename(tmp_path.c_str(), cache_path) != 0){
+		unlink(tmp_path.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+int8_t load_config_cache(const char *cache_path, uint64_t source_hash,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names)
+{
+	off_t file_size = get_filesize(cache_path);
+
+	if(file_size < (off_t) sizeof(configCacheHeader)){
+		return -1;
+	}
+
+	int fd = open(cache_path, O_RDONLY);
+
+	if(fd < 0){
+		return -1;
+	}
+
+	void *mapped = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if(mapped == MAP_FAILED){
+		return -1;
+	}
+
+	const uint8_t *data = (const uint8_t *) mapped;
+	const configCacheHeader *header = (const configCacheHeader *) data;
+
+	size_t entries_bytes = (size_t) header->entries_length * sizeof(slaveEntry);
+	size_t parameters_bytes = (size_t) header->parameters_length * sizeof(startupConfig);
+	const uint8_t *payload = data + sizeof(configCacheHeader);
+	size_t payload_bytes = file_size - sizeof(configCacheHeader);
+
+	// stale or incompatible cache is ignored
+	bool is_valid = memcmp(header->magic, CONFIG_CACHE_MAGIC, sizeof(CONFIG_CACHE_MAGIC)) == 0
+			&& header->version == CONFIG_CACHE_VERSION
+			&& header->entry_size == sizeof(slaveEntry)
+			&& header->parameter_size == sizeof(startupConfig)
+			&& header->source_hash == source_hash
+			&& entries_bytes + parameters_bytes + header->data_bytes
+				+ header->names_bytes == payload_bytes
+			&& (header->names_bytes == 0 || data[file_size - 1] == '\0')
+			&& fnv1a(payload, payload_bytes) == header->checksum;
+
+	if(is_valid){
+		const slaveEntry *entries = (const slaveEntry *) payload;
+		const startupConfig *parameters = (const startupConfig *) (payload + entries_bytes);
+		const uint8_t *data_start = payload + entries_bytes + parameters_bytes;
+		const char *names = (const char *) (data_start + header->data_bytes);
+		const char *names_end = names + header->names_bytes;
+
+		slave_entries.assign(entries, entries + header->entries_length);
+		slave_parameters.assign(parameters, parameters + header->parameters_length);
+		parameter_data.assign(data_start, data_start + header->data_bytes);
+
+		entry_names.clear();
+		while(names < names_end){
+			entry_names.push_back(names);
+			names += entry_names.back().size() + 1;
+		}
+
+		*slave_length = header->entries_length;
+		*parameters_length = header->parameters_length;
+
+		is_valid = entry_names.size() == header->names_length;
+	}
+
+	munmap(mapped, file_size);
+
+	if(!is_valid){
+		slave_entries.clear();
+		slave_parameters.clear();
+		parameter_data.clear();
+		entry_names.clear();
+		*slave_length = 0;
+		*parameters_length = 0;
+
+		return -1;
+	}
 
 	return 0;
 }
@@ -1,15 +1,14 @@
 #ifndef CONFIG_PARSER_H
 #define CONFIG_PARSER_H
-#endif
 
 #include <cstdio>
 #include <cstdint>
 #include <cctype>
 #include <vector>
+#include <string>
 
 #include <sys/stat.h>
 
-#include "rapidjson/document.h"
 #include "ecrt.h"
 
 #define swap_endian16(x) \
@@ -33,7 +32,12 @@
 		(((uint64_t)(x) & 0x00ff000000000000ULL) >> 40) | \
 		(((uint64_t)(x) & 0xff00000000000000ULL) >> 56) ))
 
-#define mask(n) ((1<<n)-1)
+#define ENTRY_NAME_NONE UINT32_MAX
+
+/** Startup parameter value is held by startupConfig.value itself. */
+#define PARAM_DATA_NONE UINT32_MAX
+
+#define mask(n) ((n) >= 64 ? ~0ULL : ((1ULL << (n)) - 1))
 
 /*****************************************************************************/
 
@@ -45,7 +49,24 @@ typedef uint16_t ecat_pos_al;
 typedef uint16_t ecat_index_al;
 typedef uint8_t ecat_sub_al;
 typedef uint8_t ecat_size_al;
-typedef uint32_t ecat_value_al;
+typedef uint64_t ecat_value_al;
+
+typedef enum entry_type_en{
+	ECAT_TYPE_UINT = 0, /**< Unsigned integer, 1..64 bits. */
+	ECAT_TYPE_INT = 1, /**< Signed integer, 1..64 bits. */
+	ECAT_TYPE_REAL32 = 2, /**< IEEE 754 single precision. */
+	ECAT_TYPE_REAL64 = 3, /**< IEEE 754 double precision. */
+	ECAT_TYPE_BITS = 4 /**< Bit string, 1..64 bits at any bit offset. */
+} entry_type_al;
+
+typedef enum param_type_en{
+	PARAM_TYPE_UINT = 0, /**< Unsigned integer, 8..64 bits. */
+	PARAM_TYPE_INT = 1, /**< Signed integer, 8..64 bits. */
+	PARAM_TYPE_REAL32 = 2,
+	PARAM_TYPE_REAL64 = 3,
+	PARAM_TYPE_STRING = 4, /**< Visible string, held in parameter data. */
+	PARAM_TYPE_OCTETS = 5 /**< Octet string, held in parameter data. */
+} param_type_al;
 
 typedef struct slaveConfig_s{
 	uint16_t alias; /**< Slave alias address. */
@@ -56,11 +77,17 @@ typedef struct slaveConfig_s{
 } slaveConfig;
 
 typedef struct startupConfig_s{
-	ecat_size_al size;
+	ecat_size_al size; /**< Value size in bits, 0 if value is in parameter data. */
 	ecat_pos_al slavePosition;
 	ecat_index_al index;
 	ecat_sub_al subindex;
-	ecat_value_al value;
+	ecat_value_al value; /**< Integer value, or bits of real value. */
+
+	uint8_t type; /**< Value type, see param_type_al. */
+	uint8_t complete_access; /**< Whole object is written, from subindex 0. */
+
+	uint32_t data_offset; /**< Value in parameter data, PARAM_DATA_NONE if in value. */
+	uint32_t data_length; /**< Value bytes in parameter data. */
 } startupConfig;
 
 typedef struct slaveEntry_s{
@@ -90,6 +117,13 @@ typedef struct slaveEntry_s{
 	ecat_value_al writtenValue;
 
 	uint8_t WATCHDOG_ENABLED;
+
+	uint8_t type; /**< Entry data type, see entry_type_al. */
+
+	double scale; /**< Engineering value = value * scale + scale_offset. */
+	double scale_offset;
+
+	uint32_t name_id; /**< Index into entry names, ENTRY_NAME_NONE if unnamed. */
 } slaveEntry;
 
 union Unit32b {
@@ -114,7 +148,81 @@ static const uint8_t SyncMEthercatDirection[] = {
 
 /*****************************************************************************/
 
+// defined in esi_parser.h
+typedef struct esiCatalog_s esiCatalog;
+
+// Receives slave configuration as SAX events, same as JSON parser emits.
+// Every event returns false if parsing must be stopped.
+class configEventSink {
+public:
+	virtual ~configEventSink() {}
+
+	virtual bool Null() = 0;
+	virtual bool Bool(bool value) = 0;
+	virtual bool Int64(int64_t value) = 0;
+	virtual bool Uint64(uint64_t value) = 0;
+	virtual bool Double(double value) = 0;
+	virtual bool String(const char *str, size_t length) = 0;
+	virtual bool Key(const char *str, size_t length) = 0; /**< NUL terminated. */
+	virtual bool StartObject() = 0;
+	virtual bool EndObject(size_t member_count) = 0;
+	virtual bool StartArray() = 0;
+	virtual bool EndArray(size_t element_count) = 0;
+};
+
+// Emits the whole slave configuration document into sink
+class configEventSource {
+public:
+	virtual ~configEventSource() {}
+
+	virtual bool emit(configEventSink &sink) = 0;
+
+	/** Location of the last emitted event, used in error messages. */
+	virtual std::string location() const = 0;
+};
+
+#define FNV1A_OFFSET 0xcbf29ce484222325ULL
+#define FNV1A_PRIME 0x100000001b3ULL
+
+extern uint64_t fnv1a(const void *data, size_t length, uint64_t hash = FNV1A_OFFSET);
+
+// Slaves without 'syncs' are resolved from ESI catalog, if it's given
 extern int8_t parse_json(const char *json_string,
 	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
 	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
-	bool do_sort_slave);
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names,
+	const char *schema_string,
+	bool do_sort_slave, const esiCatalog *esi_catalog = NULL);
+
+// JSON text, not NUL terminated
+extern int8_t parse_json_buffer(const char *json, size_t length,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names,
+	const char *schema_string,
+	bool do_sort_slave, const esiCatalog *esi_catalog = NULL);
+
+// Configuration which isn't JSON text, e.g. JS object
+extern int8_t parse_config_events(configEventSource &event_source,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names,
+	const char *schema_string,
+	bool do_sort_slave, const esiCatalog *esi_catalog = NULL);
+
+// Schema text is part of the hash, so cache is validated by the same schema
+extern uint64_t config_source_hash(const char *json, size_t length,
+	const char *schema_string, bool do_sort_slave, uint64_t esi_stamp = 0);
+
+extern int8_t save_config_cache(const char *cache_path, uint64_t source_hash,
+	const std::vector<slaveEntry> &slave_entries,
+	const std::vector<startupConfig> &slave_parameters,
+	const std::vector<uint8_t> &parameter_data,
+	const std::vector<std::string> &entry_names);
+
+extern int8_t load_config_cache(const char *cache_path, uint64_t source_hash,
+	std::vector<slaveEntry> &slave_entries, slave_size_et *slave_length,
+	std::vector<startupConfig> &slave_parameters, sparam_size_et *parameters_length,
+	std::vector<uint8_t> &parameter_data, std::vector<std::string> &entry_names);
+
+#endif
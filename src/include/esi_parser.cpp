@@ -0,0 +1,719 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include "esi_parser.h"
+
+#include <sys/stat.h>
+
+/*****************************************************************************/
+
+// parsed ESI files, reused while file size and modification time are unchanged
+struct esiFileCache {
+	off_t size;
+	struct timespec mtime;
+	std::vector<esiDevice> devices;
+};
+
+static std::mutex esi_cache_mutex;
+static std::map<std::string, esiFileCache> esi_cache;
+
+/*****************************************************************************/
+
+// ESI numbers are either decimal or hexadecimal prefixed with '#x'
+static uint32_t _esi_to_uint(const std::string &text, const char *name)
+{
+	const char *start = text.c_str();
+	while(isspace((unsigned char) *start)){
+		start++;
+	}
+
+	int base = 10;
+	if(start[0] == '#' && (start[1] == 'x' || start[1] == 'X')){
+		start += 2;
+		base = 16;
+	}
+
+	char *end;
+	unsigned long long value = strtoull(start, &end, base);
+
+	while(isspace((unsigned char) *end)){
+		end++;
+	}
+
+	if(end == start || *end != '\0' || value > UINT32_MAX){
+		throw std::invalid_argument(
+			"\"" + text + "\" is invalid value. '" + name + "' must be a number"
+		);
+	}
+
+	return value;
+}
+
+static uint8_t _esi_entry_type(const std::string &data_type, uint32_t size)
+{
+	if(data_type == "REAL" && size == 32){
+		return ECAT_TYPE_REAL32;
+	}
+
+	if(data_type == "LREAL" && size == 64){
+		return ECAT_TYPE_REAL64;
+	}
+
+	if(data_type == "SINT" || data_type == "INT" || data_type == "DINT"
+		|| data_type == "LINT" || data_type.compare(0, 3, "INT") == 0
+	){
+		return ECAT_TYPE_INT;
+	}
+
+	return ECAT_TYPE_UINT;
+}
+
+static bool _esi_device_less(const esiDevice &d1, const esiDevice &d2)
+{
+	if(d1.vendor_id != d2.vendor_id){
+		return d1.vendor_id < d2.vendor_id;
+	}
+
+	if(d1.product_code != d2.product_code){
+		return d1.product_code < d2.product_code;
+	}
+
+	return d1.revision < d2.revision;
+}
+
+/*****************************************************************************/
+
+typedef std::vector<std::pair<std::string, std::string>> esiAttributes;
+
+// Collects devices from XML events. Only default assigned PDOs of devices
+// are kept, everything else in the file is skipped.
+class esiHandler {
+public:
+	explicit esiHandler(std::vector<esiDevice> &esi_devices)
+		: devices(esi_devices), vendor_id(0), in_device(false), in_pdo(false),
+		in_entry(false), device_depth(0), pdo_depth(0), entry_depth(0)
+	{
+	}
+
+	void start_element(const std::string &name, const esiAttributes &attributes)
+	{
+		size_t depth = path.size();
+
+		if(name == "Device" && depth > 0 && path.back() == "Devices"){
+			device = esiDevice();
+			device.revision = 0;
+			pdos.clear();
+			in_device = true;
+			device_depth = depth;
+		} else if(in_device && !in_pdo && depth == device_depth + 1){
+			if(name == "Type"){
+				device.product_code = _esi_to_uint(
+					attribute(attributes, "ProductCode", "0"), "ProductCode");
+				device.revision = _esi_to_uint(
+					attribute(attributes, "RevisionNo", "0"), "RevisionNo");
+			} else if(name == "RxPdo" || name == "TxPdo"){
+				std::string sm = attribute(attributes, "Sm", "");
+
+				pdo = esiPdo();
+				pdo.is_assigned = !sm.empty();
+				pdo.sync_index = pdo.is_assigned ? _esi_to_uint(sm, "Sm") : 0;
+				pdo.direction = name == "RxPdo" ? EC_DIR_OUTPUT : EC_DIR_INPUT;
+				in_pdo = true;
+				pdo_depth = depth;
+			}
+		} else if(in_pdo && name == "Entry" && depth == pdo_depth + 1){
+			entry = esiEntry();
+			in_entry = true;
+			entry_depth = depth;
+		}
+
+		path.push_back(name);
+		text.clear();
+	}
+
+	void end_element(const std::string &name)
+	{
+		path.pop_back();
+
+		size_t depth = path.size();
+
+		if(in_entry && depth == entry_depth + 1){
+			if(name == "Index"){
+				entry.index = _esi_to_uint(text, "Index");
+			} else if(name == "SubIndex"){
+				entry.subindex = _esi_to_uint(text, "SubIndex");
+			} else if(name == "BitLen"){
+				entry.size = _esi_to_uint(text, "BitLen");
+			} else if(name == "DataType"){
+				entry.data_type = trim(text);
+			}
+		} else if(in_entry && depth == entry_depth){
+			pdo.entries.push_back(entry);
+			in_entry = false;
+		} else if(in_pdo && depth == pdo_depth + 1 && name == "Index"){
+			pdo.index = _esi_to_uint(text, "Index");
+		} else if(in_pdo && depth == pdo_depth){
+			if(pdo.is_assigned){
+				pdos.push_back(pdo);
+			}
+
+			in_pdo = false;
+		} else if(in_device && depth == device_depth + 1 && name == "Type"){
+			device.type = trim(text);
+		} else if(in_device && depth == device_depth){
+			end_device();
+			in_device = false;
+		} else if(depth == 2 && name == "Id" && path[1] == "Vendor"){
+			vendor_id = _esi_to_uint(text, "Vendor Id");
+		}
+
+		text.clear();
+	}
+
+	void characters(const char *data, size_t length)
+	{
+		// only text of leaf elements inside devices is used
+		if(in_device || path.size() == 3){
+			text.append(data, length);
+		}
+	}
+
+private:
+	struct esiEntry {
+		uint32_t index = 0;
+		uint32_t subindex = 0;
+		uint32_t size = 0;
+		std::string data_type;
+	};
+
+	struct esiPdo {
+		uint32_t index = 0;
+		uint32_t sync_index = 0;
+		uint8_t direction = 0;
+		bool is_assigned = false;
+		std::vector<esiEntry> entries;
+	};
+
+	std::vector<esiDevice> &devices;
+	std::vector<std::string> path;
+	std::string text;
+
+	uint32_t vendor_id;
+	esiDevice device;
+	std::vector<esiPdo> pdos;
+	esiPdo pdo;
+	esiEntry entry;
+
+	bool in_device;
+	bool in_pdo;
+	bool in_entry;
+	size_t device_depth;
+	size_t pdo_depth;
+	size_t entry_depth;
+
+	static std::string attribute(const esiAttributes &attributes,
+		const char *name, const char *default_value)
+	{
+		for(const auto &attr : attributes){
+			if(attr.first == name){
+				return attr.second;
+			}
+		}
+
+		return default_value;
+	}
+
+	static std::string trim(const std::string &value)
+	{
+		size_t start = value.find_first_not_of(" \t\r\n");
+		size_t end = value.find_last_not_of(" \t\r\n");
+
+		return start == std::string::npos ? "" : value.substr(start, end - start + 1);
+	}
+
+	// convert PDOs into slave entries, in the same order as parse_json()
+	void end_device()
+	{
+		device.vendor_id = vendor_id;
+
+		std::stable_sort(pdos.begin(), pdos.end(),
+			[](const esiPdo &p1, const esiPdo &p2){
+				return p1.sync_index < p2.sync_index;
+			});
+
+		for(const esiPdo &esi_pdo : pdos){
+			if(esi_pdo.sync_index > UINT8_MAX || esi_pdo.index > UINT16_MAX){
+				device.unsupported = "invalid PDO or SM index";
+				break;
+			}
+
+			size_t first_entry = device.entries.size();
+
+			for(const esiEntry &esi_entry : esi_pdo.entries){
+				if(esi_entry.size < 1 || esi_entry.size > 64){
+					device.unsupported = "entry size "
+						+ std::to_string(esi_entry.size) + " is not between 1 and 64";
+					break;
+				}
+
+				slaveEntry slave_entry = empty_entry(esi_pdo);
+				slave_entry.index = esi_entry.index;
+				slave_entry.subindex = esi_entry.subindex;
+				slave_entry.size = esi_entry.size;
+				slave_entry.add_to_domain = esi_entry.index != 0;
+				slave_entry.type = _esi_entry_type(esi_entry.data_type, esi_entry.size);
+				slave_entry.SIGNED = slave_entry.type == ECAT_TYPE_INT;
+
+				device.entries.push_back(slave_entry);
+			}
+
+			// add new slave entry if pdo doesnt have entries
+			if(device.entries.size() == first_entry){
+				device.entries.push_back(empty_entry(esi_pdo));
+			}
+		}
+
+		if(!device.unsupported.empty()){
+			device.entries.clear();
+		}
+
+		devices.push_back(device);
+	}
+
+	static slaveEntry empty_entry(const esiPdo &esi_pdo)
+	{
+		slaveEntry slave_entry = {};
+
+		slave_entry.sync_index = esi_pdo.sync_index;
+		slave_entry.pdo_index = esi_pdo.index;
+		slave_entry.direction = esi_pdo.direction;
+		slave_entry.type = ECAT_TYPE_UINT;
+		slave_entry.scale = 1;
+		slave_entry.name_id = ENTRY_NAME_NONE;
+
+		return slave_entry;
+	}
+};
+
+/*****************************************************************************/
+
+// Minimal streaming XML reader, file is read in chunks so memory usage
+// doesn't depend on file size. DTD, comments and processing instructions
+// are skipped, namespaces are not resolved.
+class esiXmlReader {
+public:
+	esiXmlReader(FILE *esi_file, esiHandler &esi_handler)
+		: file(esi_file), handler(esi_handler), length(0), pos(0), line(1)
+	{
+	}
+
+	void parse()
+	{
+		std::string text;
+		int c;
+
+		while((c = get()) != EOF){
+			if(c != '<'){
+				text.push_back(c);
+				continue;
+			}
+
+			flush_text(text);
+			parse_markup(text);
+		}
+
+		flush_text(text);
+	}
+
+	uint32_t get_line() const
+	{
+		return line;
+	}
+
+private:
+	FILE *file;
+	esiHandler &handler;
+
+	char buffer[ESI_READ_CHUNK];
+	size_t length;
+	size_t pos;
+	uint32_t line;
+
+	int get()
+	{
+		if(pos == length){
+			length = fread(buffer, 1, sizeof(buffer), file);
+			pos = 0;
+
+			if(length == 0){
+				return EOF;
+			}
+		}
+
+		char c = buffer[pos++];
+		if(c == '\n'){
+			line++;
+		}
+
+		return (unsigned char) c;
+	}
+
+	int expect_get()
+	{
+		int c = get();
+		if(c == EOF){
+			throw std::invalid_argument("Unexpected end of file");
+		}
+
+		return c;
+	}
+
+	void skip_until(const char *terminator)
+	{
+		size_t matched = 0;
+		size_t terminator_length = strlen(terminator);
+
+		while(matched < terminator_length){
+			int c = expect_get();
+
+			if(c == terminator[matched]){
+				matched++;
+			} else {
+				matched = c == terminator[0] ? 1 : 0;
+			}
+		}
+	}
+
+	void flush_text(std::string &text)
+	{
+		if(!text.empty()){
+			decode_entities(text);
+			handler.characters(text.data(), text.size());
+			text.clear();
+		}
+	}
+
+	void parse_markup(std::string &text)
+	{
+		int c = expect_get();
+
+		if(c == '?'){
+			skip_until("?>");
+			return;
+		}
+
+		if(c == '!'){
+			parse_declaration(text);
+			return;
+		}
+
+		if(c == '/'){
+			std::string name = read_name(expect_get());
+
+			if(skip_spaces() != '>'){
+				throw std::invalid_argument("Invalid end tag </" + name);
+			}
+
+			handler.end_element(name);
+			return;
+		}
+
+		std::string name = read_name(c);
+		esiAttributes attributes;
+
+		while(true){
+			c = skip_spaces();
+
+			if(c == '>'){
+				handler.start_element(name, attributes);
+				return;
+			}
+
+			if(c == '/'){
+				if(expect_get() != '>'){
+					throw std::invalid_argument("Invalid empty tag <" + name);
+				}
+
+				handler.start_element(name, attributes);
+				handler.end_element(name);
+				return;
+			}
+
+			std::string attr_name = read_name(c);
+
+			if(skip_spaces() != '='){
+				throw std::invalid_argument("Attribute '" + attr_name + "' has no value");
+			}
+
+			int quote = skip_spaces();
+			if(quote != '"' && quote != '\''){
+				throw std::invalid_argument("Attribute '" + attr_name + "' is not quoted");
+			}
+
+			std::string value;
+			while((c = expect_get()) != quote){
+				value.push_back(c);
+			}
+
+			decode_entities(value);
+			attributes.emplace_back(attr_name, value);
+		}
+	}
+
+	void parse_declaration(std::string &text)
+	{
+		int c = expect_get();
+
+		// comment
+		if(c == '-'){
+			expect_get();
+			skip_until("-->");
+			return;
+		}
+
+		// CDATA is kept as it is, without decoding entities
+		if(c == '['){
+			skip_until("CDATA[");
+
+			std::string data;
+			while(data.size() < 3 || data.compare(data.size() - 3, 3, "]]>") != 0){
+				data.push_back(expect_get());
+			}
+
+			data.resize(data.size() - 3);
+			handler.characters(data.data(), data.size());
+			return;
+		}
+
+		// DOCTYPE, may have internal subset in brackets
+		uint32_t brackets = 0;
+		while(c != '>' || brackets > 0){
+			if(c == '['){
+				brackets++;
+			} else if(c == ']'){
+				brackets--;
+			}
+
+			c = expect_get();
+		}
+	}
+
+	std::string read_name(int c)
+	{
+		std::string name;
+
+		while(!isspace(c) && c != '>' && c != '/' && c != '='){
+			name.push_back(c);
+			c = expect_get();
+		}
+
+		if(name.empty()){
+			throw std::invalid_argument("Missing tag or attribute name");
+		}
+
+		// put back delimiter
+		pos--;
+		if(c == '\n'){
+			line--;
+		}
+
+		return name;
+	}
+
+	int skip_spaces()
+	{
+		int c;
+
+		do {
+			c = expect_get();
+		} while(isspace(c));
+
+		return c;
+	}
+
+	static void decode_entities(std::string &value)
+	{
+		size_t amp = value.find('&');
+		if(amp == std::string::npos){
+			return;
+		}
+
+		std::string decoded;
+		decoded.reserve(value.size());
+		decoded.append(value, 0, amp);
+
+		for(size_t i = amp; i < value.size(); i++){
+			size_t semicolon;
+
+			if(value[i] != '&' || (semicolon = value.find(';', i)) == std::string::npos){
+				decoded.push_back(value[i]);
+				continue;
+			}
+
+			std::string entity = value.substr(i + 1, semicolon - i - 1);
+
+			if(entity == "amp"){
+				decoded.push_back('&');
+			} else if(entity == "lt"){
+				decoded.push_back('<');
+			} else if(entity == "gt"){
+				decoded.push_back('>');
+			} else if(entity == "quot"){
+				decoded.push_back('"');
+			} else if(entity == "apos"){
+				decoded.push_back('\'');
+			} else if(entity.size() > 1 && entity[0] == '#'){
+				// numeric references are only relevant in names, keep ASCII only
+				unsigned long code = entity[1] == 'x'
+					? strtoul(entity.c_str() + 2, NULL, 16)
+					: strtoul(entity.c_str() + 1, NULL, 10);
+
+				decoded.push_back(code < 0x80 ? (char) code : '?');
+			} else {
+				decoded.append(value, i, semicolon - i + 1);
+			}
+
+			i = semicolon;
+		}
+
+		value.swap(decoded);
+	}
+};
+
+/*****************************************************************************/
+
+static void _parse_esi_file(const std::string &esi_path, std::vector<esiDevice> &devices)
+{
+	FILE *file = fopen(esi_path.c_str(), "rb");
+
+	if(file == NULL){
+		throw std::invalid_argument("Failed opening ESI file " + esi_path);
+	}
+
+	esiHandler handler(devices);
+	esiXmlReader reader(file, handler);
+
+	try {
+		reader.parse();
+	} catch (const std::exception& err) {
+		fclose(file);
+
+		throw std::invalid_argument(
+			"ESI file " + esi_path + " error at line "
+			+ std::to_string(reader.get_line()) + ": " + err.what()
+		);
+	}
+
+	fclose(file);
+
+#if DEBUG > 0
+	printf("%zu device(s) are loaded from %s\n", devices.size(), esi_path.c_str());
+#endif
+}
+
+static void _stat_esi_file(const std::string &esi_path, struct stat *st)
+{
+	if(stat(esi_path.c_str(), st) != 0){
+		throw std::invalid_argument("ESI file " + esi_path + " is not found");
+	}
+}
+
+uint64_t esi_files_stamp(const std::vector<std::string> &esi_paths)
+{
+	uint64_t stamp = FNV1A_OFFSET;
+
+	// compiled configuration depends on ESI files as well
+	for(const std::string &esi_path : esi_paths){
+		struct stat st;
+		_stat_esi_file(esi_path, &st);
+
+		int64_t identity[3] = { st.st_size, st.st_mtim.tv_sec, st.st_mtim.tv_nsec };
+		stamp = fnv1a(esi_path.c_str(), esi_path.size() + 1, stamp);
+		stamp = fnv1a(identity, sizeof(identity), stamp);
+	}
+
+	return stamp;
+}
+
+int8_t load_esi_catalog(const std::vector<std::string> &esi_paths, esiCatalog &catalog)
+{
+	catalog.devices.clear();
+	catalog.stamp = esi_files_stamp(esi_paths);
+
+	std::lock_guard<std::mutex> lock(esi_cache_mutex);
+
+	for(const std::string &esi_path : esi_paths){
+		struct stat st;
+		_stat_esi_file(esi_path, &st);
+
+		esiFileCache &cached = esi_cache[esi_path];
+
+		bool is_stale = cached.size != st.st_size
+				|| cached.mtime.tv_sec != st.st_mtim.tv_sec
+				|| cached.mtime.tv_nsec != st.st_mtim.tv_nsec;
+
+		if(is_stale){
+			std::vector<esiDevice> devices;
+
+			try {
+				_parse_esi_file(esi_path, devices);
+			} catch (...) {
+				esi_cache.erase(esi_path);
+				throw;
+			}
+
+			cached.size = st.st_size;
+			cached.mtime = st.st_mtim;
+			cached.devices.swap(devices);
+		}
+
+		catalog.devices.insert(catalog.devices.end(),
+			cached.devices.begin(), cached.devices.end());
+	}
+
+	// devices defined in earlier files take precedence
+	std::stable_sort(catalog.devices.begin(), catalog.devices.end(), _esi_device_less);
+
+	return 0;
+}
+
+const esiDevice *find_esi_device(const esiCatalog &catalog, uint32_t vendor_id,
+	uint32_t product_code, uint32_t revision, bool has_revision)
+{
+	esiDevice key;
+	key.vendor_id = vendor_id;
+	key.product_code = product_code;
+	key.revision = 0;
+
+	auto first = std::lower_bound(catalog.devices.begin(), catalog.devices.end(),
+		key, _esi_device_less);
+
+	key.revision = UINT32_MAX;
+	auto last = std::upper_bound(first, catalog.devices.end(), key, _esi_device_less);
+
+	if(first == last){
+		return NULL;
+	}
+
+	// use the latest revision if it's not specified
+	if(!has_revision){
+		uint32_t latest = (last - 1)->revision;
+
+		return &*std::lower_bound(first, last, latest,
+			[](const esiDevice &device, uint32_t value){
+				return device.revision < value;
+			});
+	}
+
+	for(auto device = first; device != last; device++){
+		if(device->revision == revision){
+			return &*device;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,44 @@
+#ifndef ESI_PARSER_H
+#define ESI_PARSER_H
+
+#include <vector>
+#include <string>
+
+#include "config_parser.h"
+
+/** Size of chunks the ESI file is read in. */
+#define ESI_READ_CHUNK (64 * 1024)
+
+/*****************************************************************************/
+
+typedef struct esiDevice_s{
+	uint32_t vendor_id; /**< Vendor ID of ESI file. */
+	uint32_t product_code;
+	uint32_t revision;
+	std::string type; /**< Device type name, e.g. EL1008. */
+
+	/** Default assigned PDOs as slave entries, without slave identity. */
+	std::vector<slaveEntry> entries;
+
+	/** Reason if PDOs can't be represented as slave entries, empty if they can. */
+	std::string unsupported;
+} esiDevice;
+
+// Devices of all loaded ESI files, sorted by vendor_id, product_code, revision
+typedef struct esiCatalog_s{
+	std::vector<esiDevice> devices;
+	uint64_t stamp; /**< Hash of ESI paths, sizes and modification times. */
+} esiCatalog;
+
+/*****************************************************************************/
+
+// Hash of ESI paths, sizes and modification times, files aren't parsed
+extern uint64_t esi_files_stamp(const std::vector<std::string> &esi_paths);
+
+extern int8_t load_esi_catalog(const std::vector<std::string> &esi_paths,
+	esiCatalog &catalog);
+
+extern const esiDevice *find_esi_device(const esiCatalog &catalog,
+	uint32_t vendor_id, uint32_t product_code, uint32_t revision, bool has_revision);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MOVING_AVERAGE_H
+#define MOVING_AVERAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*****************************************************************************/
+
+// Moving average of last N samples, fixed size and allocation free
+template <size_t N>
+struct movingAverage {
+	int64_t samples[N];
+	int64_t sum;
+	size_t head;
+	size_t count;
+
+	void reset()
+	{
+		sum = 0;
+		head = 0;
+		count = 0;
+	}
+
+	void add(int64_t sample)
+	{
+		if(count == N){
+			sum -= samples[head];
+		} else {
+			count++;
+		}
+
+		samples[head] = sample;
+		sum += sample;
+
+		head = (head + 1) % N;
+	}
+
+	double value() const
+	{
+		return count ? (double) sum / count : 0;
+	}
+};
+
+#endif
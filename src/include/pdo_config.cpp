@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include "pdo_config.h"
+
+// PDO of a slave while its layout is being built
+typedef struct pdoDraft_s{
+	ecat_index_al index;
+	std::vector<ec_pdo_entry_info_t> entries;
+} pdoDraft;
+
+// SM of a slave while its layout is being built
+typedef struct syncDraft_s{
+	uint8_t index;
+	ec_direction_t dir;
+	ec_watchdog_mode_t watchdog_mode;
+	std::vector<pdoDraft> pdos;
+} syncDraft;
+
+/*****************************************************************************/
+
+static void _add_entry(std::vector<syncDraft> &syncs, const slaveEntry &entry)
+{
+	auto sync = std::find_if(syncs.begin(), syncs.end(),
+		[&entry](const syncDraft &draft){ return draft.index == entry.sync_index; });
+
+	if(sync == syncs.end()){
+		syncDraft draft = {
+				entry.sync_index,
+				(ec_direction_t) entry.direction,
+				entry.WATCHDOG_ENABLED ? EC_WD_ENABLE : EC_WD_DISABLE,
+				{}
+			};
+
+		syncs.push_back(draft);
+		sync = syncs.end() - 1;
+	}
+
+	auto pdo = std::find_if(sync->pdos.begin(), sync->pdos.end(),
+		[&entry](const pdoDraft &draft){ return draft.index == entry.pdo_index; });
+
+	if(pdo == sync->pdos.end()){
+		sync->pdos.push_back({ entry.pdo_index, {} });
+		pdo = sync->pdos.end() - 1;
+	}
+
+	// entry without index, subindex and size assigns PDO with empty mapping
+	if(!entry.index && !entry.subindex && !entry.size){
+		return;
+	}
+
+	// the same entry listed twice in a row is mapped once
+	if(!pdo->entries.empty()
+		&& pdo->entries.back().index == entry.index
+		&& pdo->entries.back().subindex == entry.subindex
+		&& pdo->entries.back().bit_length == entry.size
+	){
+		return;
+	}
+
+	pdo->entries.push_back({ entry.index, entry.subindex, entry.size });
+}
+
+// identical layouts have identical keys
+static std::string _layout_key(const std::vector<syncDraft> &syncs)
+{
+	std::string key;
+
+	for(const syncDraft &sync : syncs){
+		uint8_t header[] = {
+				sync.index,
+				(uint8_t) sync.dir,
+				(uint8_t) sync.watchdog_mode,
+				(uint8_t) (sync.pdos.size() & 0xff),
+				(uint8_t) (sync.pdos.size() >> 8)
+			};
+
+		key.append((const char*) header, sizeof(header));
+
+		for(const pdoDraft &pdo : sync.pdos){
+			uint8_t pdo_header[] = {
+					(uint8_t) (pdo.index & 0xff),
+					(uint8_t) (pdo.index >> 8),
+					(uint8_t) (pdo.entries.size() & 0xff),
+					(uint8_t) (pdo.entries.size() >> 8)
+				};
+
+			key.append((const char*) pdo_header, sizeof(pdo_header));
+
+			for(const ec_pdo_entry_info_t &entry : pdo.entries){
+				uint8_t entry_key[] = {
+						(uint8_t) (entry.index & 0xff),
+						(uint8_t) (entry.index >> 8),
+						entry.subindex,
+						entry.bit_length
+					};
+
+				key.append((const char*) entry_key, sizeof(entry_key));
+			}
+		}
+	}
+
+	return key;
+}
+
+static void _build_layout(const std::vector<syncDraft> &syncs, pdoLayout &layout)
+{
+	size_t n_pdos = 0;
+	size_t n_entries = 0;
+
+	for(const syncDraft &sync : syncs){
+		n_pdos += sync.pdos.size();
+
+		for(const pdoDraft &pdo : sync.pdos){
+			n_entries += pdo.entries.size();
+		}
+	}
+
+	// reserved, so pointers into entries and pdos stay valid
+	layout.entries.reserve(n_entries);
+	layout.pdos.reserve(n_pdos);
+	layout.syncs.reserve(syncs.size() + 1);
+
+	for(const syncDraft &sync : syncs){
+		size_t first_pdo = layout.pdos.size();
+
+		for(const pdoDraft &pdo : sync.pdos){
+			size_t first_entry = layout.entries.size();
+
+			layout.entries.insert(layout.entries.end(),
+				pdo.entries.begin(), pdo.entries.end());
+
+			layout.pdos.push_back({
+					pdo.index,
+					(unsigned int) pdo.entries.size(),
+					pdo.entries.empty() ? NULL : &layout.entries[first_entry]
+				});
+		}
+
+		layout.syncs.push_back({
+				sync.index,
+				sync.dir,
+				(unsigned int) sync.pdos.size(),
+				sync.pdos.empty() ? NULL : &layout.pdos[first_pdo],
+				sync.watchdog_mode
+			});
+	}
+
+	layout.syncs.push_back({ PDO_CONFIG_SYNC_END, EC_DIR_INVALID, 0, NULL, EC_WD_DEFAULT });
+}
+
+/*****************************************************************************/
+
+void build_pdo_config(const std::vector<slaveEntry> &slave_entries, pdoConfig &config)
+{
+	// SMs of every slave by position, in order of their first entry
+	std::map<ecat_pos_al, std::vector<syncDraft>> slave_syncs;
+
+	for(const slaveEntry &entry : slave_entries){
+		// invalid pdo index use default configuration
+		if(!entry.pdo_index){
+			continue;
+		}
+
+		_add_entry(slave_syncs[entry.position], entry);
+	}
+
+	std::map<std::string, size_t> layout_indexes;
+
+	config.layouts.clear();
+	config.slaves.clear();
+
+	// layouts are only counted first, so they aren't moved once built
+	std::vector<size_t> slave_layouts;
+	slave_layouts.reserve(slave_syncs.size());
+
+	for(const auto &slave : slave_syncs){
+		auto inserted = layout_indexes.insert(std::make_pair(
+				_layout_key(slave.second), layout_indexes.size()));
+
+		slave_layouts.push_back(inserted.first->second);
+	}
+
+	config.layouts.resize(layout_indexes.size());
+	config.slaves.reserve(slave_syncs.size());
+
+	size_t i_slave = 0;
+	for(const auto &slave : slave_syncs){
+		size_t i_layout = slave_layouts[i_slave++];
+
+		if(config.layouts[i_layout].syncs.empty()){
+			_build_layout(slave.second, config.layouts[i_layout]);
+		}
+
+		config.slaves.push_back(std::make_pair(slave.first, i_layout));
+	}
+}
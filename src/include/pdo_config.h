@@ -0,0 +1,37 @@
+#ifndef PDO_CONFIG_H
+#define PDO_CONFIG_H
+
+#include <vector>
+#include <utility>
+
+#include "ecrt.h"
+#include "config_parser.h"
+
+/** Sync index terminating ec_sync_info_t list. */
+#define PDO_CONFIG_SYNC_END 0xff
+
+/*****************************************************************************/
+
+// SMs, PDOs and PDO entries of a slave, as taken by ecrt_slave_config_pdos()
+typedef struct pdoLayout_s{
+	std::vector<ec_pdo_entry_info_t> entries;
+	std::vector<ec_pdo_info_t> pdos; /**< Point into entries, empty mapping if n_entries is 0. */
+	std::vector<ec_sync_info_t> syncs; /**< Point into pdos, terminated by PDO_CONFIG_SYNC_END. */
+} pdoLayout;
+
+// Layouts of all slaves, slaves with identical layout share the same one
+typedef struct pdoConfig_s{
+	std::vector<pdoLayout> layouts;
+
+	/** Slave position and index of its layout, sorted by position. */
+	std::vector<std::pair<ecat_pos_al, size_t>> slaves;
+} pdoConfig;
+
+/*****************************************************************************/
+
+// Group slave entries into layouts, in configuration order. Entries without
+// PDO index are left out, so slaves without any use their default PDOs.
+extern void build_pdo_config(const std::vector<slaveEntry> &slave_entries,
+	pdoConfig &config);
+
+#endif
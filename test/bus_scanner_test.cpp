@@ -0,0 +1,128 @@
+// scan_bus() on simulated bus, its entries must equal parse_json() of the
+// configuration it produces
+#include <stdexcept>
+
+#include "bus_scanner.h"
+#include "ecrt_stub.h"
+#include "test.h"
+
+/*****************************************************************************/
+
+// coupler, digital outputs with an unmapped PDO, analog inputs with mailbox
+// SMs and a gap
+static void fixture_bus()
+{
+	stub_reset();
+
+	stub_bus.push_back({ 0, 0x00000002, 0x044c2c52, 0x00120000, {} });
+
+	stubSlave outputs = { 0, 0x00000002, 0x07d83052, 0x00100000, {} };
+	outputs.syncs.push_back({ 0, EC_DIR_OUTPUT, EC_WD_ENABLE, {
+			{ 0x1600, { { 0x7000, 0x01, 1 } } },
+			{ 0x1601, { { 0x7010, 0x01, 1 } } },
+			{ 0x1602, {} },
+		} });
+	stub_bus.push_back(outputs);
+
+	stubSlave inputs = { 5, 0x00000002, 0x0c1e3052, 0x00140000, {} };
+	inputs.syncs.push_back({ 0, EC_DIR_OUTPUT, EC_WD_DEFAULT, {} });
+	inputs.syncs.push_back({ 1, EC_DIR_INPUT, EC_WD_DEFAULT, {} });
+	inputs.syncs.push_back({ 2, EC_DIR_OUTPUT, EC_WD_DEFAULT, {} });
+	inputs.syncs.push_back({ 3, EC_DIR_INPUT, EC_WD_DISABLE, {
+			{ 0x1a00, { { 0x6000, 0x01, 1 }, { 0x0000, 0x00, 7 }, { 0x6000, 0x11, 16 } } },
+			{ 0x1a01, { { 0x6010, 0x11, 16 } } },
+		} });
+	stub_bus.push_back(inputs);
+}
+
+static bool is_equal_entry(const slaveEntry &a, const slaveEntry &b)
+{
+	return a.alias == b.alias && a.position == b.position
+		&& a.vendor_id == b.vendor_id && a.product_code == b.product_code
+		&& a.sync_index == b.sync_index && a.pdo_index == b.pdo_index
+		&& a.index == b.index && a.subindex == b.subindex && a.size == b.size
+		&& a.add_to_domain == b.add_to_domain && a.offset == b.offset
+		&& a.bit_position == b.bit_position && a.value == b.value
+		&& a.direction == b.direction && a.SWAP_ENDIAN == b.SWAP_ENDIAN
+		&& a.SIGNED == b.SIGNED && a.writtenValue == b.writtenValue
+		&& a.WATCHDOG_ENABLED == b.WATCHDOG_ENABLED && a.type == b.type
+		&& a.scale == b.scale && a.scale_offset == b.scale_offset
+		&& a.name_id == b.name_id;
+}
+
+static void test_scan_equals_parse(ec_master_t *master)
+{
+	fixture_bus();
+
+	std::string json;
+	std::vector<slaveEntry> scanned;
+	slave_size_et scanned_length = 0;
+
+	CHECK_EQUAL(scan_bus(master, json, scanned, &scanned_length), 0);
+
+	// coupler, 3 PDOs of outputs and 4 entries of inputs
+	CHECK_EQUAL(scanned_length, 8);
+	CHECK_EQUAL(scanned.size(), scanned_length);
+
+	std::vector<slaveEntry> parsed;
+	slave_size_et parsed_length = 0;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length = 0;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+
+	CHECK_EQUAL(parse_json(json.c_str(), parsed, &parsed_length, parameters,
+		&parameters_length, parameter_data, names, NULL, false), 0);
+
+	CHECK_EQUAL(parsed_length, scanned_length);
+	CHECK_EQUAL(parsed.size(), scanned.size());
+	CHECK_EQUAL(parameters_length, 0);
+
+	for(size_t i_entry = 0; i_entry < scanned.size() && i_entry < parsed.size(); i_entry++){
+		if(!is_equal_entry(scanned[i_entry], parsed[i_entry])){
+			fprintf(stderr, "entry %zu of scan differs from parsed one\n", i_entry);
+			test_failures++;
+		}
+	}
+
+	// gap is not added to domain, unmapped PDO has entry without object
+	CHECK_EQUAL(scanned[5].index, 0x0000);
+	CHECK_EQUAL(scanned[5].add_to_domain, 0);
+	CHECK_EQUAL(scanned[3].pdo_index, 0x1602);
+	CHECK_EQUAL(scanned[3].index, 0x0000);
+	CHECK_EQUAL(scanned[7].alias, 5);
+}
+
+static void test_scan_rejects_entry_size(ec_master_t *master)
+{
+	fixture_bus();
+	stub_bus[2].syncs[3].pdos[1].entries[0].bit_length = 0;
+
+	std::string json;
+	std::vector<slaveEntry> scanned(1);
+	slave_size_et scanned_length = 0;
+	bool is_rejected = false;
+
+	try {
+		scan_bus(master, json, scanned, &scanned_length);
+	} catch (const std::invalid_argument&) {
+		is_rejected = true;
+	}
+
+	// entries given before scan are kept
+	CHECK(is_rejected);
+	CHECK_EQUAL(scanned.size(), 1);
+	CHECK_EQUAL(scanned_length, 0);
+}
+
+int main()
+{
+	ec_master_t *master = ecrt_request_master(0);
+
+	test_scan_equals_parse(master);
+	test_scan_rejects_entry_size(master);
+
+	ecrt_release_master(master);
+
+	return test_result("bus_scanner_test");
+}
@@ -0,0 +1,119 @@
+// plan_capacity() against frame, datagram and wire time worked out by hand
+#include <string>
+
+#include "capacity_planner.h"
+#include "test.h"
+
+/*****************************************************************************/
+
+// Slave with one SM of 'entries' entries of 'size' bits, all in domain
+static std::string slave_json(uint16_t position, const char *direction,
+	uint16_t entries, uint8_t size)
+{
+	char text[160];
+
+	snprintf(text, sizeof(text), "{\"alias\":0,\"position\":%u,"
+		"\"vendor_id\":\"0x00000002\",\"product_code\":\"0x0c1e3052\","
+		"\"syncs\":[{\"index\":%u,\"direction\":\"%s\",\"pdos\":[{\"index\":\"0x%04x\","
+		"\"entries\":[", position, direction[0] == 'i' ? 3 : 2, direction,
+		direction[0] == 'i' ? 0x1a00 : 0x1600);
+
+	std::string json = text;
+
+	for(uint16_t i_entry = 0; i_entry < entries; i_entry++){
+		snprintf(text, sizeof(text), "%s{\"index\":\"0x6000\",\"subindex\":\"0x%02x\","
+			"\"size\":%u,\"add_to_domain\":true}", i_entry ? "," : "", i_entry + 1, size);
+		json += text;
+	}
+
+	return json + "]}]}]}";
+}
+
+static void plan(const std::string &json, uint32_t period_ns, capacityReport &report)
+{
+	std::vector<slaveEntry> entries;
+	slave_size_et entries_length = 0;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length = 0;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+
+	parse_json(json.c_str(), entries, &entries_length, parameters,
+		&parameters_length, parameter_data, names, NULL, false);
+
+	capacityOptions options = { CAPACITY_LINK_SPEED, CAPACITY_SLAVE_DELAY_NS, period_ns };
+	plan_capacity(entries, options, report);
+}
+
+// 2 bytes + 12 datagram + 2 EtherCAT header is padded to 46, plus 38 of
+// Ethernet overhead is 84 bytes, 80 ns each at 100 Mbit/s
+static void test_single_slave()
+{
+	capacityReport report;
+	plan("[" + slave_json(0, "output", 1, 16) + "]", 1000000, report);
+
+	CHECK_EQUAL(report.domain_size, 2);
+	CHECK_EQUAL(report.output_bytes, 2);
+	CHECK_EQUAL(report.input_bytes, 0);
+	CHECK_EQUAL(report.datagrams, 1);
+	CHECK_EQUAL(report.frames, 1);
+	CHECK_EQUAL(report.wire_bytes, 84);
+	CHECK_EQUAL(report.wire_time_ns, 6720);
+	CHECK_EQUAL(report.bus_time_ns, 7720);
+	CHECK_EQUAL(report.min_period_ns, 8000);
+	CHECK(report.load > 0.00771 && report.load < 0.00773);
+
+	CHECK_EQUAL(report.slaves.size(), 1);
+	CHECK_EQUAL(report.slaves[0].output_bytes, 2);
+	CHECK_EQUAL(report.slaves[0].wire_time_ns, 160 + 1000);
+}
+
+// three SMs of 600 bytes, third one doesn't fit into 1486 bytes of first
+// datagram. Datagrams of 1200 and 600 bytes don't fit into one frame either.
+static void test_datagram_split()
+{
+	capacityReport report;
+	plan("[" + slave_json(0, "input", 75, 64) + "," + slave_json(1, "input", 75, 64)
+		+ "," + slave_json(2, "input", 75, 64) + "]", 0, report);
+
+	CHECK_EQUAL(report.domain_size, 1800);
+	CHECK_EQUAL(report.input_bytes, 1800);
+	CHECK_EQUAL(report.datagrams, 2);
+	CHECK_EQUAL(report.frames, 2);
+
+	// (2 + 1200 + 12 + 38) + (2 + 600 + 12 + 38)
+	CHECK_EQUAL(report.wire_bytes, 1252 + 652);
+	CHECK_EQUAL(report.wire_time_ns, 1904 * 80);
+	CHECK_EQUAL(report.bus_time_ns, 1904 * 80 + 3 * 1000);
+	CHECK_EQUAL(report.min_period_ns, 156000);
+	CHECK(report.load == 0);
+
+	CHECK_EQUAL(report.slaves.size(), 3);
+	CHECK_EQUAL(report.slaves[2].position, 2);
+	CHECK_EQUAL(report.slaves[2].input_bytes, 600);
+	CHECK_EQUAL(report.slaves[2].wire_time_ns, 600 * 80 + 1000);
+}
+
+// entry listed twice in a row is mapped once, like pdo_config does
+static void test_repeated_entry()
+{
+	capacityReport report;
+	plan("[{\"alias\":0,\"position\":0,\"vendor_id\":2,\"product_code\":1,"
+		"\"syncs\":[{\"index\":2,\"pdos\":[{\"index\":\"0x1600\",\"entries\":["
+			"{\"index\":\"0x7000\",\"subindex\":1,\"size\":16,\"add_to_domain\":true},"
+			"{\"index\":\"0x7000\",\"subindex\":1,\"size\":16,\"add_to_domain\":true},"
+			"{\"index\":\"0x7000\",\"subindex\":2,\"size\":8,\"add_to_domain\":true}"
+		"]}]}]}]", 0, report);
+
+	CHECK_EQUAL(report.domain_size, 3);
+	CHECK_EQUAL(report.output_bytes, 3);
+}
+
+int main()
+{
+	test_single_slave();
+	test_datagram_split();
+	test_repeated_entry();
+
+	return test_result("capacity_planner_test");
+}
@@ -0,0 +1,94 @@
+// Configuration parsing details which aren't visible from JS
+#include <string>
+
+#include "config_parser.h"
+#include "test.h"
+
+/*****************************************************************************/
+
+static int8_t parse(const std::string &json, std::vector<slaveEntry> &entries)
+{
+	slave_size_et entries_length = 0;
+	std::vector<startupConfig> parameters;
+	sparam_size_et parameters_length = 0;
+	std::vector<uint8_t> parameter_data;
+	std::vector<std::string> names;
+
+	int8_t result = parse_json(json.c_str(), entries, &entries_length, parameters,
+		&parameters_length, parameter_data, names, NULL, false);
+
+	CHECK_EQUAL(entries_length, entries.size());
+
+	return result;
+}
+
+// remappable PDO after a PDO of 8 bits gets a gap of 24 bits, so its entries
+// sorted widest first are aligned from start of SM
+static void test_remappable_alignment()
+{
+	std::vector<slaveEntry> entries;
+
+	CHECK_EQUAL(parse("[{\"alias\":0,\"position\":0,\"vendor_id\":2,\"product_code\":1,"
+		"\"syncs\":[{\"index\":3,\"pdos\":["
+			"{\"index\":\"0x1a00\",\"entries\":["
+				"{\"index\":\"0x6000\",\"subindex\":1,\"size\":8,\"add_to_domain\":true}]},"
+			"{\"index\":\"0x1a01\",\"remappable\":true,\"entries\":["
+				"{\"index\":\"0x6010\",\"subindex\":1,\"size\":1,\"add_to_domain\":true},"
+				"{\"index\":\"0x6010\",\"subindex\":2,\"size\":16,\"add_to_domain\":true},"
+				"{\"index\":\"0x6010\",\"subindex\":3,\"size\":32,\"add_to_domain\":true}]}"
+		"]}]}]", entries), 0);
+
+	CHECK_EQUAL(entries.size(), 5);
+	if(entries.size() != 5){
+		return;
+	}
+
+	CHECK_EQUAL(entries[1].pdo_index, 0x1a01);
+	CHECK_EQUAL(entries[1].index, 0x0000);
+	CHECK_EQUAL(entries[1].size, 24);
+	CHECK_EQUAL(entries[1].add_to_domain, 0);
+	CHECK_EQUAL(entries[1].sync_index, 3);
+
+	CHECK_EQUAL(entries[2].subindex, 3);
+	CHECK_EQUAL(entries[3].subindex, 2);
+	CHECK_EQUAL(entries[4].subindex, 1);
+
+	// bit offset of every entry from start of SM
+	uint32_t offset = 0;
+	for(const slaveEntry &entry : entries){
+		if(entry.index && entry.size >= 8){
+			CHECK_EQUAL(offset % entry.size, 0);
+		}
+
+		offset += entry.size;
+	}
+}
+
+// PDO already starting aligned isn't padded
+static void test_remappable_aligned_start()
+{
+	std::vector<slaveEntry> entries;
+
+	CHECK_EQUAL(parse("[{\"alias\":0,\"position\":0,\"vendor_id\":2,\"product_code\":1,"
+		"\"syncs\":[{\"index\":3,\"pdos\":["
+			"{\"index\":\"0x1a00\",\"entries\":["
+				"{\"index\":\"0x6000\",\"subindex\":1,\"size\":16,\"add_to_domain\":true}]},"
+			"{\"index\":\"0x1a01\",\"remappable\":true,\"entries\":["
+				"{\"index\":\"0x6010\",\"subindex\":1,\"size\":8,\"add_to_domain\":true},"
+				"{\"index\":\"0x6010\",\"subindex\":2,\"size\":16,\"add_to_domain\":true}]}"
+		"]}]}]", entries), 0);
+
+	CHECK_EQUAL(entries.size(), 3);
+	if(entries.size() == 3){
+		CHECK_EQUAL(entries[1].subindex, 2);
+		CHECK_EQUAL(entries[2].subindex, 1);
+	}
+}
+
+int main()
+{
+	test_remappable_alignment();
+	test_remappable_aligned_start();
+
+	return test_result("config_parser_test");
+}
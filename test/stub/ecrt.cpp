@@ -0,0 +1,535 @@
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include "ecrt_stub.h"
+
+/*****************************************************************************/
+
+struct ec_slave_config {
+	uint16_t alias;
+	uint16_t position;
+	uint32_t vendor_id;
+	uint32_t product_code;
+};
+
+struct ec_domain {
+	std::vector<uint8_t> data;
+	uint32_t bits; /**< Registered process data, in bits. */
+	uint32_t entries;
+};
+
+struct ec_sdo_request {
+	uint16_t index;
+	uint8_t subindex;
+	std::vector<uint8_t> data;
+	ec_request_state_t state;
+};
+
+struct ec_master {
+	bool is_activated;
+	std::vector<std::unique_ptr<ec_slave_config>> configs;
+	std::vector<std::unique_ptr<ec_domain>> domains;
+	std::vector<std::unique_ptr<ec_sdo_request>> requests;
+};
+
+std::vector<stubSlave> stub_bus;
+stubCalls stub_calls = {};
+
+// only one master is requested at a time
+static ec_master *stub_master = NULL;
+
+void stub_reset()
+{
+	stub_bus.clear();
+	stub_calls = {};
+}
+
+inline static const stubSync *_stub_sync(uint16_t position, uint8_t sync_index)
+{
+	if(position >= stub_bus.size()
+		|| sync_index >= stub_bus[position].syncs.size()
+	){
+		return NULL;
+	}
+
+	return &stub_bus[position].syncs[sync_index];
+}
+
+inline static const stubPdo *_stub_pdo(uint16_t position, uint8_t sync_index,
+	uint16_t pdo_pos)
+{
+	const stubSync *sync = _stub_sync(position, sync_index);
+
+	if(sync == NULL || pdo_pos >= sync->pdos.size()){
+		return NULL;
+	}
+
+	return &sync->pdos[pdo_pos];
+}
+
+inline static uint64_t _stub_entry_key(uint64_t position, uint16_t index,
+	uint8_t subindex)
+{
+	return (position << 24) | ((uint32_t) index << 8) | subindex;
+}
+
+/*****************************************************************************/
+
+ec_master_t *ecrt_request_master(unsigned int index)
+{
+	stub_calls.total++;
+
+	if(index != 0 || stub_master != NULL){
+		return NULL;
+	}
+
+	stub_master = new ec_master();
+
+	return stub_master;
+}
+
+ec_master_t *ecrt_open_master(unsigned int index)
+{
+	return ecrt_request_master(index);
+}
+
+void ecrt_release_master(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	if(master == stub_master){
+		delete stub_master;
+		stub_master = NULL;
+	}
+}
+
+int ecrt_master(ec_master_t *master, ec_master_info_t *master_info)
+{
+	stub_calls.total++;
+
+	memset(master_info, 0, sizeof(*master_info));
+	master_info->slave_count = stub_bus.size();
+	master_info->link_up = 1;
+
+	return 0;
+}
+
+int ecrt_master_get_slave(ec_master_t *master, uint16_t slave_position,
+	ec_slave_info_t *slave_info)
+{
+	stub_calls.total++;
+
+	if(slave_position >= stub_bus.size()){
+		return -1;
+	}
+
+	const stubSlave &slave = stub_bus[slave_position];
+
+	memset(slave_info, 0, sizeof(*slave_info));
+	slave_info->position = slave_position;
+	slave_info->alias = slave.alias;
+	slave_info->vendor_id = slave.vendor_id;
+	slave_info->product_code = slave.product_code;
+	slave_info->revision_number = slave.revision_number;
+	slave_info->sync_count = slave.syncs.size();
+
+	return 0;
+}
+
+int ecrt_master_get_sync_manager(ec_master_t *master, uint16_t slave_position,
+	uint8_t sync_index, ec_sync_info_t *sync)
+{
+	stub_calls.total++;
+
+	const stubSync *found = _stub_sync(slave_position, sync_index);
+
+	if(found == NULL){
+		return -1;
+	}
+
+	sync->index = found->index;
+	sync->dir = found->dir;
+	sync->n_pdos = found->pdos.size();
+	sync->pdos = NULL;
+	sync->watchdog_mode = found->watchdog_mode;
+
+	return 0;
+}
+
+int ecrt_master_get_pdo(ec_master_t *master, uint16_t slave_position,
+	uint8_t sync_index, uint16_t pos, ec_pdo_info_t *pdo)
+{
+	stub_calls.total++;
+
+	const stubPdo *found = _stub_pdo(slave_position, sync_index, pos);
+
+	if(found == NULL){
+		return -1;
+	}
+
+	pdo->index = found->index;
+	pdo->n_entries = found->entries.size();
+	pdo->entries = NULL;
+
+	return 0;
+}
+
+int ecrt_master_get_pdo_entry(ec_master_t *master, uint16_t slave_position,
+	uint8_t sync_index, uint16_t pdo_pos, uint16_t entry_pos,
+	ec_pdo_entry_info_t *entry)
+{
+	stub_calls.total++;
+
+	const stubPdo *found = _stub_pdo(slave_position, sync_index, pdo_pos);
+
+	if(found == NULL || entry_pos >= found->entries.size()){
+		return -1;
+	}
+
+	*entry = found->entries[entry_pos];
+
+	return 0;
+}
+
+ec_domain_t *ecrt_master_create_domain(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	master->domains.emplace_back(new ec_domain());
+
+	return master->domains.back().get();
+}
+
+ec_slave_config_t *ecrt_master_slave_config(ec_master_t *master, uint16_t alias,
+	uint16_t position, uint32_t vendor_id, uint32_t product_code)
+{
+	stub_calls.total++;
+	stub_calls.slave_config++;
+
+	master->configs.emplace_back(
+		new ec_slave_config{ alias, position, vendor_id, product_code });
+
+	return master->configs.back().get();
+}
+
+int ecrt_master_activate(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	// domain memory is allocated by master on activation
+	for(const auto &domain : master->domains){
+		domain->data.assign((domain->bits + 7) / 8, 0);
+	}
+
+	master->is_activated = true;
+
+	return 0;
+}
+
+int ecrt_master_deactivate(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	master->is_activated = false;
+
+	return 0;
+}
+
+int ecrt_master_send(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	return 0;
+}
+
+int ecrt_master_receive(ec_master_t *master)
+{
+	stub_calls.total++;
+
+	return 0;
+}
+
+// all slaves reach OP as soon as master is activated
+int ecrt_master_state(const ec_master_t *master, ec_master_state_t *state)
+{
+	stub_calls.total++;
+
+	state->slaves_responding = stub_bus.size();
+	state->al_states = master->is_activated ? 0x08 : 0x02;
+	state->link_up = 1;
+
+	return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_slave_config_sync_manager(ec_slave_config_t *sc, uint8_t sync_index,
+	ec_direction_t direction, ec_watchdog_mode_t watchdog_mode)
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+
+	return 0;
+}
+
+int ecrt_slave_config_pdo_assign_add(ec_slave_config_t *sc, uint8_t sync_index,
+	uint16_t index)
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+
+	return 0;
+}
+
+void ecrt_slave_config_pdo_assign_clear(ec_slave_config_t *sc, uint8_t sync_index)
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+}
+
+int ecrt_slave_config_pdo_mapping_add(ec_slave_config_t *sc, uint16_t pdo_index,
+	uint16_t entry_index, uint8_t entry_subindex, uint8_t entry_bit_length)
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+
+	return 0;
+}
+
+void ecrt_slave_config_pdo_mapping_clear(ec_slave_config_t *sc, uint16_t pdo_index)
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+}
+
+// walks the whole list, like master copying it
+int ecrt_slave_config_pdos(ec_slave_config_t *sc, unsigned int n_syncs,
+	const ec_sync_info_t syncs[])
+{
+	stub_calls.total++;
+	stub_calls.pdo_config++;
+
+	volatile uint32_t bits = 0;
+
+	for(unsigned int i_sync = 0; i_sync < n_syncs; i_sync++){
+		if(syncs[i_sync].index == 0xff){
+			break;
+		}
+
+		for(unsigned int i_pdo = 0; i_pdo < syncs[i_sync].n_pdos; i_pdo++){
+			const ec_pdo_info_t &pdo = syncs[i_sync].pdos[i_pdo];
+
+			for(unsigned int i_entry = 0; i_entry < pdo.n_entries; i_entry++){
+				bits += pdo.entries[i_entry].bit_length;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int ecrt_slave_config_sdo(ec_slave_config_t *sc, uint16_t index, uint8_t subindex,
+	const uint8_t *data, size_t size)
+{
+	stub_calls.total++;
+	stub_calls.sdo_config++;
+
+	return 0;
+}
+
+int ecrt_slave_config_sdo8(ec_slave_config_t *sc, uint16_t index, uint8_t subindex,
+	uint8_t value)
+{
+	return ecrt_slave_config_sdo(sc, index, subindex, &value, 1);
+}
+
+int ecrt_slave_config_sdo16(ec_slave_config_t *sc, uint16_t index, uint8_t subindex,
+	uint16_t value)
+{
+	return ecrt_slave_config_sdo(sc, index, subindex, (const uint8_t *) &value, 2);
+}
+
+int ecrt_slave_config_sdo32(ec_slave_config_t *sc, uint16_t index, uint8_t subindex,
+	uint32_t value)
+{
+	return ecrt_slave_config_sdo(sc, index, subindex, (const uint8_t *) &value, 4);
+}
+
+int ecrt_slave_config_complete_sdo(ec_slave_config_t *sc, uint16_t index,
+	const uint8_t *data, size_t size)
+{
+	return ecrt_slave_config_sdo(sc, index, 0, data, size);
+}
+
+ec_sdo_request_t *ecrt_slave_config_create_sdo_request(ec_slave_config_t *sc,
+	uint16_t index, uint8_t subindex, size_t size)
+{
+	stub_calls.total++;
+
+	stub_master->requests.emplace_back(new ec_sdo_request{
+			index,
+			subindex,
+			std::vector<uint8_t>(size, 0),
+			EC_REQUEST_UNUSED
+		});
+
+	return stub_master->requests.back().get();
+}
+
+int ecrt_slave_config_state(const ec_slave_config_t *sc,
+	ec_slave_config_state_t *state)
+{
+	stub_calls.total++;
+
+	bool is_operational = stub_master != NULL && stub_master->is_activated;
+
+	state->online = sc->position < stub_bus.size();
+	state->operational = is_operational && state->online;
+	state->al_state = state->operational ? 0x08 : 0x02;
+
+	return 0;
+}
+
+/*****************************************************************************/
+
+// entries are laid out in registration order, multi-byte entries byte-aligned
+int ecrt_domain_reg_pdo_entry_list(ec_domain_t *domain,
+	const ec_pdo_entry_reg_t *pdo_entry_regs)
+{
+	stub_calls.total++;
+
+	// bit length by position, index and subindex
+	std::unordered_map<uint64_t, uint8_t> bit_lengths;
+	for(size_t position = 0; position < stub_bus.size(); position++){
+		for(const stubSync &sync : stub_bus[position].syncs){
+			for(const stubPdo &pdo : sync.pdos){
+				for(const ec_pdo_entry_info_t &entry : pdo.entries){
+					bit_lengths[_stub_entry_key(position, entry.index, entry.subindex)]
+						= entry.bit_length;
+				}
+			}
+		}
+	}
+
+	for(const ec_pdo_entry_reg_t *reg = pdo_entry_regs; reg->index; reg++){
+		auto found = bit_lengths.find(
+			_stub_entry_key(reg->position, reg->index, reg->subindex));
+
+		// entries not on simulated bus take one byte
+		uint8_t bit_length = found != bit_lengths.end() ? found->second : 8;
+
+		if(bit_length % 8 == 0 || reg->bit_position == NULL){
+			domain->bits = (domain->bits + 7) / 8 * 8;
+		}
+
+		*reg->offset = domain->bits / 8;
+		if(reg->bit_position != NULL){
+			*reg->bit_position = domain->bits % 8;
+		}
+
+		domain->bits += bit_length;
+		domain->entries++;
+
+		stub_calls.pdo_entry_reg++;
+	}
+
+	return 0;
+}
+
+size_t ecrt_domain_size(const ec_domain_t *domain)
+{
+	stub_calls.total++;
+
+	return (domain->bits + 7) / 8;
+}
+
+uint8_t *ecrt_domain_data(ec_domain_t *domain)
+{
+	stub_calls.total++;
+
+	return domain->data.empty() ? NULL : &domain->data[0];
+}
+
+int ecrt_domain_process(ec_domain_t *domain)
+{
+	stub_calls.total++;
+
+	return 0;
+}
+
+int ecrt_domain_queue(ec_domain_t *domain)
+{
+	stub_calls.total++;
+
+	return 0;
+}
+
+int ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state)
+{
+	stub_calls.total++;
+
+	state->working_counter = domain->entries;
+	state->wc_state = EC_WC_COMPLETE;
+	state->redundancy_active = 0;
+
+	return 0;
+}
+
+/*****************************************************************************/
+
+int ecrt_sdo_request_index(ec_sdo_request_t *req, uint16_t index, uint8_t subindex)
+{
+	stub_calls.total++;
+
+	req->index = index;
+	req->subindex = subindex;
+
+	return 0;
+}
+
+int ecrt_sdo_request_timeout(ec_sdo_request_t *req, uint32_t timeout)
+{
+	stub_calls.total++;
+
+	return 0;
+}
+
+uint8_t *ecrt_sdo_request_data(ec_sdo_request_t *req)
+{
+	stub_calls.total++;
+
+	return req->data.empty() ? NULL : &req->data[0];
+}
+
+size_t ecrt_sdo_request_data_size(const ec_sdo_request_t *req)
+{
+	stub_calls.total++;
+
+	return req->data.size();
+}
+
+ec_request_state_t ecrt_sdo_request_state(ec_sdo_request_t *req)
+{
+	stub_calls.total++;
+
+	return req->state;
+}
+
+// requests complete at once, read data is what was last written
+int ecrt_sdo_request_write(ec_sdo_request_t *req)
+{
+	stub_calls.total++;
+
+	req->state = EC_REQUEST_SUCCESS;
+
+	return 0;
+}
+
+int ecrt_sdo_request_read(ec_sdo_request_t *req)
+{
+	stub_calls.total++;
+
+	req->state = EC_REQUEST_SUCCESS;
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+/* Stand-in of EtherLab's ecrt.h for tests and benchmarks. Only the part of
+ * the API used by the addon is declared, see ecrt.cpp for simulated master. */
+#ifndef ECRT_STUB_ECRT_H
+#define ECRT_STUB_ECRT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <endian.h>
+#define EC_MAX_SYNC_MANAGERS 16
+#define EC_MAX_STRING_LENGTH 64
+#define EC_MAX_PORTS 4
+#define EC_END ~0U
+typedef struct ec_master ec_master_t;
+typedef struct ec_slave_config ec_slave_config_t;
+typedef struct ec_domain ec_domain_t;
+typedef struct ec_sdo_request ec_sdo_request_t;
+typedef struct { unsigned int slaves_responding; unsigned int al_states : 4; unsigned int link_up : 1; } ec_master_state_t;
+typedef struct { unsigned int online : 1; unsigned int operational : 1; unsigned int al_state : 4; } ec_slave_config_state_t;
+typedef enum { EC_WC_ZERO = 0, EC_WC_INCOMPLETE, EC_WC_COMPLETE } ec_wc_state_t;
+typedef struct { unsigned int working_counter; ec_wc_state_t wc_state; unsigned int redundancy_active; } ec_domain_state_t;
+typedef enum { EC_DIR_INVALID, EC_DIR_OUTPUT, EC_DIR_INPUT, EC_DIR_COUNT } ec_direction_t;
+typedef enum { EC_WD_DEFAULT, EC_WD_ENABLE, EC_WD_DISABLE } ec_watchdog_mode_t;
+typedef enum { EC_REQUEST_UNUSED, EC_REQUEST_BUSY, EC_REQUEST_SUCCESS, EC_REQUEST_ERROR } ec_request_state_t;
+typedef struct { uint16_t index; uint8_t subindex; uint8_t bit_length; } ec_pdo_entry_info_t;
+typedef struct { uint16_t index; unsigned int n_entries; ec_pdo_entry_info_t *entries; } ec_pdo_info_t;
+typedef struct { uint8_t index; ec_direction_t dir; unsigned int n_pdos; ec_pdo_info_t *pdos; ec_watchdog_mode_t watchdog_mode; } ec_sync_info_t;
+typedef struct { uint16_t alias; uint16_t position; uint32_t vendor_id; uint32_t product_code; uint16_t index; uint8_t subindex; unsigned int *offset; unsigned int *bit_position; } ec_pdo_entry_reg_t;
+typedef enum { EC_PORT_NOT_IMPLEMENTED } ec_slave_port_desc_t;
+typedef struct { uint8_t link_up; uint8_t loop_closed; uint8_t signal_detected; } ec_slave_port_link_t;
+typedef struct { uint16_t position; uint32_t vendor_id; uint32_t product_code; uint32_t revision_number; uint32_t serial_number; uint16_t alias; int16_t current_on_ebus; struct { ec_slave_port_desc_t desc; ec_slave_port_link_t link; uint32_t receive_time; uint16_t next_slave; uint32_t delay_to_next_dc; } ports[EC_MAX_PORTS]; uint8_t al_state; uint8_t error_flag; uint8_t sync_count; uint16_t sdo_count; char name[EC_MAX_STRING_LENGTH]; } ec_slave_info_t;
+typedef struct { unsigned int slave_count; unsigned int link_up : 1; uint8_t scan_busy; uint64_t app_time; } ec_master_info_t;
+ec_master_t *ecrt_request_master(unsigned int);
+ec_master_t *ecrt_open_master(unsigned int);
+void ecrt_release_master(ec_master_t *);
+int ecrt_master(ec_master_t *, ec_master_info_t *);
+int ecrt_master_get_slave(ec_master_t *, uint16_t, ec_slave_info_t *);
+int ecrt_master_get_sync_manager(ec_master_t *, uint16_t, uint8_t, ec_sync_info_t *);
+int ecrt_master_get_pdo(ec_master_t *, uint16_t, uint8_t, uint16_t, ec_pdo_info_t *);
+int ecrt_master_get_pdo_entry(ec_master_t *, uint16_t, uint8_t, uint16_t, uint16_t, ec_pdo_entry_info_t *);
+ec_domain_t *ecrt_master_create_domain(ec_master_t *);
+ec_slave_config_t *ecrt_master_slave_config(ec_master_t *, uint16_t, uint16_t, uint32_t, uint32_t);
+int ecrt_master_activate(ec_master_t *);
+int ecrt_master_deactivate(ec_master_t *);
+int ecrt_master_send(ec_master_t *);
+int ecrt_master_receive(ec_master_t *);
+int ecrt_master_state(const ec_master_t *, ec_master_state_t *);
+int ecrt_slave_config_sync_manager(ec_slave_config_t *, uint8_t, ec_direction_t, ec_watchdog_mode_t);
+int ecrt_slave_config_pdo_assign_add(ec_slave_config_t *, uint8_t, uint16_t);
+void ecrt_slave_config_pdo_assign_clear(ec_slave_config_t *, uint8_t);
+int ecrt_slave_config_pdo_mapping_add(ec_slave_config_t *, uint16_t, uint16_t, uint8_t, uint8_t);
+void ecrt_slave_config_pdo_mapping_clear(ec_slave_config_t *, uint16_t);
+int ecrt_slave_config_pdos(ec_slave_config_t *, unsigned int, const ec_sync_info_t *);
+int ecrt_slave_config_sdo(ec_slave_config_t *, uint16_t, uint8_t, const uint8_t *, size_t);
+int ecrt_slave_config_sdo8(ec_slave_config_t *, uint16_t, uint8_t, uint8_t);
+int ecrt_slave_config_sdo16(ec_slave_config_t *, uint16_t, uint8_t, uint16_t);
+int ecrt_slave_config_sdo32(ec_slave_config_t *, uint16_t, uint8_t, uint32_t);
+int ecrt_slave_config_complete_sdo(ec_slave_config_t *, uint16_t, const uint8_t *, size_t);
+ec_sdo_request_t *ecrt_slave_config_create_sdo_request(ec_slave_config_t *, uint16_t, uint8_t, size_t);
+int ecrt_slave_config_state(const ec_slave_config_t *, ec_slave_config_state_t *);
+int ecrt_domain_reg_pdo_entry_list(ec_domain_t *, const ec_pdo_entry_reg_t *);
+size_t ecrt_domain_size(const ec_domain_t *);
+uint8_t *ecrt_domain_data(ec_domain_t *);
+int ecrt_domain_process(ec_domain_t *);
+int ecrt_domain_queue(ec_domain_t *);
+int ecrt_domain_state(const ec_domain_t *, ec_domain_state_t *);
+int ecrt_sdo_request_index(ec_sdo_request_t *, uint16_t, uint8_t);
+int ecrt_sdo_request_timeout(ec_sdo_request_t *, uint32_t);
+uint8_t *ecrt_sdo_request_data(ec_sdo_request_t *);
+size_t ecrt_sdo_request_data_size(const ec_sdo_request_t *);
+ec_request_state_t ecrt_sdo_request_state(ec_sdo_request_t *);
+int ecrt_sdo_request_write(ec_sdo_request_t *);
+int ecrt_sdo_request_read(ec_sdo_request_t *);
+#define EC_READ_BIT(DATA, POS) ((*((uint8_t *) (DATA)) >> (POS)) & 0x01)
+#define EC_WRITE_BIT(DATA, POS, VAL) do { if (VAL) *((uint8_t *) (DATA)) |= (1 << (POS)); else *((uint8_t *) (DATA)) &= ~(1 << (POS)); } while (0)
+#define EC_READ_U8(DATA) ((uint8_t) *((uint8_t *) (DATA)))
+#define EC_READ_S8(DATA) ((int8_t) *((uint8_t *) (DATA)))
+#define EC_READ_U16(DATA) ((uint16_t) le16toh(*((uint16_t *) (DATA))))
+#define EC_READ_S16(DATA) ((int16_t) le16toh(*((uint16_t *) (DATA))))
+#define EC_READ_U32(DATA) ((uint32_t) le32toh(*((uint32_t *) (DATA))))
+#define EC_READ_S32(DATA) ((int32_t) le32toh(*((uint32_t *) (DATA))))
+#define EC_READ_U64(DATA) ((uint64_t) le64toh(*((uint64_t *) (DATA))))
+#define EC_READ_S64(DATA) ((int64_t) le64toh(*((uint64_t *) (DATA))))
+#define EC_WRITE_U8(DATA, VAL) do { *((uint8_t *)(DATA)) = ((uint8_t) (VAL)); } while (0)
+#define EC_WRITE_S8(DATA, VAL) EC_WRITE_U8(DATA, VAL)
+#define EC_WRITE_U16(DATA, VAL) do { *((uint16_t *) (DATA)) = htole16((uint16_t) (VAL)); } while (0)
+#define EC_WRITE_S16(DATA, VAL) EC_WRITE_U16(DATA, VAL)
+#define EC_WRITE_U32(DATA, VAL) do { *((uint32_t *) (DATA)) = htole32((uint32_t) (VAL)); } while (0)
+#define EC_WRITE_S32(DATA, VAL) EC_WRITE_U32(DATA, VAL)
+#define EC_WRITE_U64(DATA, VAL) do { *((uint64_t *) (DATA)) = htole64((uint64_t) (VAL)); } while (0)
+#define EC_WRITE_S64(DATA, VAL) EC_WRITE_U64(DATA, VAL)
+
+#endif
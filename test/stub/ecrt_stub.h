@@ -0,0 +1,50 @@
+#ifndef ECRT_STUB_H
+#define ECRT_STUB_H
+
+#include <vector>
+
+#include "ecrt.h"
+
+/*****************************************************************************/
+
+typedef struct stubPdo_s{
+	uint16_t index;
+	std::vector<ec_pdo_entry_info_t> entries;
+} stubPdo;
+
+typedef struct stubSync_s{
+	uint8_t index;
+	ec_direction_t dir;
+	ec_watchdog_mode_t watchdog_mode;
+	std::vector<stubPdo> pdos; /**< Empty for mailbox SMs. */
+} stubSync;
+
+// Slave on simulated bus, its position is its index in stub_bus
+typedef struct stubSlave_s{
+	uint16_t alias;
+	uint32_t vendor_id;
+	uint32_t product_code;
+	uint32_t revision_number;
+	std::vector<stubSync> syncs;
+} stubSlave;
+
+// Library calls made since stub_reset()
+typedef struct stubCalls_s{
+	uint32_t slave_config; /**< ecrt_master_slave_config() */
+	uint32_t pdo_config; /**< SM, PDO assignment and PDO mapping calls. */
+	uint32_t sdo_config; /**< Startup SDOs. */
+	uint32_t pdo_entry_reg; /**< PDO entries registered into domains. */
+	uint32_t total;
+} stubCalls;
+
+/*****************************************************************************/
+
+// Slaves found by master, read by ecrt_master_get_slave() and friends
+extern std::vector<stubSlave> stub_bus;
+
+extern stubCalls stub_calls;
+
+// Clear bus and call counters
+extern void stub_reset();
+
+#endif
@@ -0,0 +1,200 @@
+/* Stand-in of node-addon-api for tests and benchmarks, so addon is built
+ * without node. Values are empty, calls do nothing. */
+#ifndef NAPI_STUB_NAPI_H
+#define NAPI_STUB_NAPI_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+#include <memory>
+
+typedef enum { napi_ok, napi_invalid_arg, napi_queue_full, napi_closing } napi_status;
+typedef struct napi_env__ *napi_env;
+typedef struct napi_value__ *napi_value;
+typedef enum { napi_int8_array, napi_uint8_array, napi_uint8_clamped_array, napi_int16_array, napi_uint16_array, napi_int32_array, napi_uint32_array, napi_float32_array, napi_float64_array, napi_bigint64_array, napi_biguint64_array } napi_typedarray_type;
+
+namespace Napi {
+class Value; class Object; class Function; class String; class Env; class Error;
+
+class Env {
+public:
+	Env(napi_env e = nullptr) : _e(e) {}
+	operator napi_env() const { return _e; }
+	Value Null() const; Value Undefined() const; Object Global() const;
+	template <typename T> T* GetInstanceData() const { return nullptr; }
+	template <typename T> static void DefaultFini(Env, T*) {}
+	template <typename T, void (*fini)(Env, T*) = DefaultFini<T>> void SetInstanceData(T*) const {}
+	bool IsExceptionPending() const { return false; }
+	napi_env _e;
+};
+
+class Value {
+public:
+	Value() {}
+	Value(napi_env, napi_value) {}
+	operator napi_value() const { return nullptr; }
+	template <typename T> static Value From(napi_env, const T&) { return Value(); }
+	template <typename T> T As() const { return T(); }
+	Napi::Env Env() const { return Napi::Env(); }
+	bool IsNumber() const { return false; } bool IsString() const { return false; }
+	bool IsBoolean() const { return false; } bool IsObject() const { return false; }
+	bool IsArray() const { return false; } bool IsFunction() const { return false; }
+	bool IsBuffer() const { return false; } bool IsTypedArray() const { return false; }
+	bool IsBigInt() const { return false; } bool IsUndefined() const { return false; }
+	bool IsNull() const { return false; } bool IsArrayBuffer() const { return false; }
+	bool IsExternal() const { return false; } bool IsEmpty() const { return false; }
+	bool ToBoolean() const { return false; }
+	Value ToNumber() const { return Value(); }
+	bool StrictEquals(const Value&) const { return false; }
+};
+
+class Boolean : public Value { public:
+	static Boolean New(napi_env, bool) { return Boolean(); }
+	operator bool() const { return false; } bool Value() const { return false; } };
+class Number : public Value { public:
+	static Number New(napi_env, double) { return Number(); }
+	operator int32_t() const { return 0; } operator uint32_t() const { return 0; }
+	operator int64_t() const { return 0; } operator float() const { return 0; }
+	operator double() const { return 0; }
+	int32_t Int32Value() const { return 0; } uint32_t Uint32Value() const { return 0; }
+	int64_t Int64Value() const { return 0; } float FloatValue() const { return 0; }
+	double DoubleValue() const { return 0; } };
+class BigInt : public Value { public:
+	static BigInt New(napi_env, int64_t) { return BigInt(); }
+	static BigInt New(napi_env, uint64_t) { return BigInt(); }
+	int64_t Int64Value(bool*) const { return 0; } uint64_t Uint64Value(bool*) const { return 0; } };
+class String : public Value { public:
+	static String New(napi_env, const char*) { return String(); }
+	static String New(napi_env, const char*, size_t) { return String(); }
+	static String New(napi_env, const std::string&) { return String(); }
+	operator std::string() const { return ""; }
+	std::string Utf8Value() const { return ""; } };
+
+class PropertyLValue { public:
+	template <typename T> PropertyLValue& operator=(const T&) { return *this; }
+	operator Value() const { return Value(); } };
+
+class Object : public Value { public:
+	static Object New(napi_env) { return Object(); }
+	template <typename K, typename V> bool Set(const K&, const V&) const { return true; }
+	template <typename K> Value Get(const K&) const { return Value(); }
+	template <typename K> bool Has(const K&) const { return false; }
+	PropertyLValue operator[](const char*) const { return PropertyLValue(); }
+	PropertyLValue operator[](uint32_t) const { return PropertyLValue(); }
+	class Array GetPropertyNames() const; };
+
+class Array : public Object { public:
+	static Array New(napi_env) { return Array(); }
+	static Array New(napi_env, size_t) { return Array(); }
+	uint32_t Length() const { return 0; } };
+inline Array Object::GetPropertyNames() const { return Array(); }
+
+class ArrayBuffer : public Object { public:
+	void* Data() { return nullptr; } size_t ByteLength() { return 0; }
+	static ArrayBuffer New(napi_env, size_t) { return ArrayBuffer(); } };
+
+class TypedArray : public Object { public:
+	napi_typedarray_type TypedArrayType() const { return napi_uint8_array; }
+	size_t ElementLength() const { return 0; } size_t ByteOffset() const { return 0; }
+	size_t ByteLength() const { return 0; }
+	Napi::ArrayBuffer ArrayBuffer() const { return Napi::ArrayBuffer(); } };
+template <typename T> class TypedArrayOf : public TypedArray { public:
+	static TypedArrayOf New(napi_env, size_t length) {
+		TypedArrayOf array; array._data = std::make_shared<std::vector<T>>(length); return array; }
+	static TypedArrayOf New(napi_env env, size_t length, Napi::ArrayBuffer, size_t) { return New(env, length); }
+	T& operator[](size_t i) { return (*_data)[i]; }
+	T* Data() { return _data ? _data->data() : nullptr; }
+	const T* Data() const { return _data ? _data->data() : nullptr; }
+	std::shared_ptr<std::vector<T>> _data; };
+typedef TypedArrayOf<uint8_t> Uint8Array; typedef TypedArrayOf<int32_t> Int32Array;
+typedef TypedArrayOf<uint32_t> Uint32Array; typedef TypedArrayOf<double> Float64Array;
+typedef TypedArrayOf<float> Float32Array;
+typedef TypedArrayOf<int64_t> BigInt64Array; typedef TypedArrayOf<uint64_t> BigUint64Array;
+
+template <typename T> class Buffer : public Uint8Array { public:
+	static Buffer New(napi_env, size_t) { return Buffer(); }
+	static Buffer Copy(napi_env, const T*, size_t) { return Buffer(); }
+	T* Data() const { return nullptr; } size_t Length() const { return 0; } };
+
+template <typename T> class External : public Value { public:
+	static External New(napi_env, T*) { return External(); }
+	T* Data() const { return nullptr; } };
+
+class CallbackInfo { public:
+	size_t Length() const { return 0; }
+	const Value operator[](size_t) const { return Value(); }
+	Napi::Env Env() const { return Napi::Env(); }
+	Value This() const { return Value(); }
+	void* Data() const { return nullptr; } };
+
+typedef Value (*Callback)(const CallbackInfo&);
+class Function : public Object { public:
+	template <typename Cb> static Function New(napi_env, Cb, const char* = nullptr, void* = nullptr) { return Function(); }
+	Value Call(const std::initializer_list<napi_value>&) const { return Value(); }
+	Value Call(const std::vector<napi_value>&) const { return Value(); }
+	Value Call(napi_value, const std::initializer_list<napi_value>&) const { return Value(); } };
+
+class Error : public Object { public:
+	static Error New(napi_env) { return Error(); }
+	static Error New(napi_env, const char*) { return Error(); }
+	static Error New(napi_env, const std::string&) { return Error(); }
+	static void Fatal(const char*, const char*) {}
+	void ThrowAsJavaScriptException() const {}
+	Object Value() const { return Object(); } };
+class TypeError : public Error { public:
+	static TypeError New(napi_env, const char*) { return TypeError(); }
+	static TypeError New(napi_env, const std::string&) { return TypeError(); } };
+class RangeError : public Error { public:
+	static RangeError New(napi_env, const char*) { return RangeError(); }
+	static RangeError New(napi_env, const std::string&) { return RangeError(); } };
+
+class Promise : public Object { public:
+	class Deferred { public:
+		static Deferred New(napi_env) { return Deferred(); }
+		Napi::Promise Promise() const { return Napi::Promise(); }
+		void Resolve(napi_value) const {} void Reject(napi_value) const {}
+		Napi::Env Env() const { return Napi::Env(); } }; };
+
+class FunctionReference { public:
+	Function Value() const { return Function(); }
+	bool IsEmpty() const { return true; } void Reset() {} };
+inline FunctionReference Persistent(Function) { return FunctionReference(); }
+class ObjectReference { public:
+	Object Value() const { return Object(); } void Reset() {} };
+inline ObjectReference Persistent(Object) { return ObjectReference(); }
+
+class ThreadSafeFunction { public:
+	template <typename C, typename F, typename D>
+	static ThreadSafeFunction New(napi_env, const Function&, const char*, size_t, size_t, C*, F, D*) { return ThreadSafeFunction(); }
+	template <typename C>
+	static ThreadSafeFunction New(napi_env, const Function&, const char*, size_t, size_t, C*) { return ThreadSafeFunction(); }
+	static ThreadSafeFunction New(napi_env, const Function&, const char*, size_t, size_t) { return ThreadSafeFunction(); }
+	template <typename D, typename Cb> napi_status BlockingCall(D*, Cb) const { return napi_ok; }
+	template <typename D, typename Cb> napi_status NonBlockingCall(D*, Cb) const { return napi_ok; }
+	template <typename Cb> napi_status BlockingCall(Cb) const { return napi_ok; }
+	template <typename Cb> napi_status NonBlockingCall(Cb) const { return napi_ok; }
+	napi_status Acquire() const { return napi_ok; } napi_status Release() const { return napi_ok; }
+	napi_status Abort() const { return napi_ok; }
+	napi_status Ref(napi_env) const { return napi_ok; } napi_status Unref(napi_env) const { return napi_ok; } };
+
+template <typename C, typename D, void (*CallJs)(Env, Function, C*, D*)>
+class TypedThreadSafeFunction { public:
+	template <typename F, typename FD>
+	static TypedThreadSafeFunction New(napi_env, const Function&, const char*, size_t, size_t, C*, F, FD*) { return TypedThreadSafeFunction(); }
+	napi_status BlockingCall(D* = nullptr) const { return napi_ok; }
+	napi_status NonBlockingCall(D* = nullptr) const { return napi_ok; }
+	napi_status Acquire() const { return napi_ok; } napi_status Release() const { return napi_ok; }
+	napi_status Abort() const { return napi_ok; } };
+
+inline Value Env::Null() const { return Value(); }
+inline Value Env::Undefined() const { return Value(); }
+inline Object Env::Global() const { return Object(); }
+}
+
+#define NODE_API_MODULE(name, fn) \
+	Napi::Object (*napi_module_init)(Napi::Env, Napi::Object) = fn;
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdio>
+
+// Failed checks of the test, test fails if there's any
+static int test_failures = 0;
+
+#define CHECK(_condition) do { \
+		if(!(_condition)){ \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+				#_condition); \
+			test_failures++; \
+		} \
+	} while(0)
+
+#define CHECK_EQUAL(_actual, _expected) do { \
+		if((_actual) != (_expected)){ \
+			fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, \
+				__LINE__, #_actual, (long long) (_actual), (long long) (_expected)); \
+			test_failures++; \
+		} \
+	} while(0)
+
+inline static int test_result(const char *name)
+{
+	printf("%s: %s\n", name, test_failures ? "FAILED" : "passed");
+
+	return test_failures ? 1 : 0;
+}
+
+#endif